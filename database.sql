@@ -1,5 +1,10 @@
 -- Attendance Management System Database Schema
 -- MySQL Database
+--
+-- This is schema version 0. Later changes (indexes, new tables) are numbered
+-- migrations in src/Migrations.cpp. Both the CLI and the API server apply
+-- pending ones at startup unless config.txt sets auto_migrate=false; they can
+-- also be applied on their own with: ./attendance_system --migrate
 
 CREATE DATABASE IF NOT EXISTS attendance_system;
 USE attendance_system;
@@ -0,0 +1,84 @@
+#ifndef ACCESSLOG_H
+#define ACCESSLOG_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Request log for the API server. Each worker thread appends fixed-size
+// records to its own single-producer ring (no locks, no allocation, no
+// I/O); one background thread drains every ring a few times a second and
+// writes them as JSON lines to a size-rotated file (path, path.1, ...).
+// A full ring drops records rather than blocking the request.
+class AccessLog {
+public:
+    // keepFiles counts the live file. sampleRate in [0, 1] is the fraction
+    // of requests recorded; 5xx responses are always recorded.
+    AccessLog(const string& path, size_t maxFileBytes, int keepFiles, double sampleRate);
+    // Writes out everything already logged, then stops the writer
+    ~AccessLog();
+
+    AccessLog(const AccessLog&) = delete;
+    AccessLog& operator=(const AccessLog&) = delete;
+
+    bool isOpen() const { return enabled.load(memory_order_relaxed); }
+
+    void log(const string& method, const string& requestPath, int status,
+             chrono::microseconds latency, chrono::microseconds dbTime, size_t bytes);
+
+private:
+    struct Record {
+        int64_t timeMs;         // wall clock, unix milliseconds
+        uint32_t latencyUs;
+        uint32_t dbUs;
+        uint32_t bytes;
+        uint16_t status;
+        char method[8];
+        char path[98];          // truncated, NUL-terminated
+    };
+
+    static constexpr size_t ringSize = 2048;  // records per thread, power of two
+
+    struct Ring {
+        Record slots[ringSize];
+        atomic<uint64_t> head{0};      // next slot the worker writes
+        atomic<uint64_t> tail{0};      // next slot the writer reads
+        atomic<uint64_t> dropped{0};
+        uint64_t random;               // worker-only sampling state
+    };
+
+    string path;
+    size_t maxFileBytes;
+    int keepFiles;
+    uint64_t sampleThreshold;          // keep when a random 64-bit value is below this
+    bool sampleAll;
+
+    // Rings are registered once per thread and live as long as the log
+    mutex ringsMutex;
+    vector<unique_ptr<Ring>> rings;
+
+    ofstream out;                      // writer thread only once running
+    size_t fileBytes = 0;
+    atomic<bool> enabled{false};
+
+    mutex wakeMutex;
+    condition_variable wake;
+    bool stopping = false;
+    thread writer;
+
+    Ring& localRing();
+    void run();
+    bool drain(string& buffer);
+    void rotate();
+};
+
+#endif // ACCESSLOG_H
@@ -2,10 +2,14 @@
 #define ADMINCONTROLLER_H
 
 #include "BaseController.h"
+#include "TeacherAssignmentIndex.h"
 
 class AdminController : public BaseController {
+private:
+    TeacherAssignmentIndex& assignments;  // kept in step with assignments made here
+
 public:
-    AdminController(Database* db);
+    AdminController(Database* db, TeacherAssignmentIndex& assignments);
     
     void createSubject();
     void createClass();
@@ -0,0 +1,124 @@
+#ifndef ATTENDANCEBITMAPINDEX_H
+#define ATTENDANCEBITMAPINDEX_H
+
+#include "ConnectionPool.h"
+#include "Models.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// The term's attendance as two bitsets per (student, subject), indexed by
+// day of term: bit d of `marked` is set when the student has a record on
+// that day, and the same bit of `present` when the record is Present. Any
+// date-range count is then an AND with a range mask plus a popcount over a
+// few words per row (AVX2 or SSSE3 when the CPU has them) instead of a scan
+// of attendance_records. Marks outside [termStart, termEnd] are not indexed.
+// Writes made through this process keep it current; marks written elsewhere
+// (the CLI) only appear after the next periodic rebuild (refreshEvery).
+class AttendanceBitmapIndex {
+public:
+    struct Counts {
+        int total = 0;
+        int present = 0;
+        double percentage() const { return total > 0 ? present * 100.0 / total : 0.0; }
+    };
+
+    struct StudentCounts {
+        int studentId = 0;
+        Counts counts;
+    };
+
+    struct ClassReport {
+        int sessions = 0;       // days with at least one mark
+        int perfectDays = 0;    // sessions where every mark was Present
+        Counts counts;
+    };
+
+    AttendanceBitmapIndex(ConnectionPool& pool, const Date& termStart, const Date& termEnd);
+    // Waits for a background rebuild in progress, then stops that thread
+    ~AttendanceBitmapIndex();
+
+    AttendanceBitmapIndex(const AttendanceBitmapIndex&) = delete;
+    AttendanceBitmapIndex& operator=(const AttendanceBitmapIndex&) = delete;
+
+    // Reloads every class's attendance from the database. Marks recorded
+    // while it runs are replayed onto the new bitsets before they go live.
+    bool rebuild();
+    // Runs rebuild() on a background thread soon, for changes no single
+    // forget* call describes (a deleted class's records). Requests made
+    // while one is pending share it.
+    void scheduleRebuild();
+    // Also rebuilds every `interval` on that thread; zero turns it off
+    void refreshEvery(chrono::seconds interval);
+
+    // Keep the index in step with committed writes
+    void record(int studentId, int subjectId, const Date& date, AttendanceStatus status);
+    void forgetStudent(int studentId);
+    void forgetSubject(int subjectId);
+
+    const Date& termStart() const { return start; }
+    const Date& termEnd() const { return end; }
+    size_t rowCount() const;
+
+    // Invalid (unset) from/to mean the start/end of the term
+    Counts studentSubject(int studentId, int subjectId, const Date& from, const Date& to) const;
+    // Every student with marks in the range, ordered by id
+    vector<StudentCounts> schoolReport(const Date& from, const Date& to) const;
+    // Over the given students' rows for one subject
+    ClassReport classReport(const vector<int>& studentIds, int subjectId,
+                            const Date& from, const Date& to) const;
+
+    // Popcount kernel picked for this CPU: "avx2", "ssse3" or "scalar"
+    static const char* kernelName();
+
+private:
+    // Row r keeps its marked words at bits[2 * r * words] and its present
+    // words right after, so one row is one contiguous run
+    struct Bitmaps {
+        unordered_map<uint64_t, uint32_t> rows;   // (student << 32 | subject) -> row
+        vector<pair<int, int>> keys;              // row -> (student, subject); (0, 0) once forgotten
+        vector<uint64_t> bits;
+        vector<uint32_t> freeRows;                // forgotten rows, reused by the next new key
+    };
+
+    ConnectionPool& pool;
+    Date start;
+    Date end;
+    int firstDay;           // day number of termStart
+    int days;
+    size_t words;           // per bitset, padded to whole 256-bit vectors
+
+    mutable shared_mutex lock;
+    Bitmaps current;
+
+    // Serialises rebuilds. Changes that arrive while one is loading are
+    // queued in `replay` (guarded by `lock`) and applied to its result.
+    mutex rebuildMutex;
+    bool rebuilding = false;
+    vector<function<void(Bitmaps&)>> replay;
+
+    // Background rebuilds, started by the first scheduleRebuild()
+    mutex refreshMutex;
+    condition_variable refreshWake;
+    bool rebuildRequested = false;
+    bool stopping = false;
+    chrono::seconds refreshInterval{0};
+    thread refresher;
+    void refreshLoop();
+
+    void apply(const function<void(Bitmaps&)>& change);
+    void setMark(Bitmaps& maps, int studentId, int subjectId, int day, bool present) const;
+    void forget(Bitmaps& maps, const function<bool(const pair<int, int>&)>& match) const;
+    vector<uint64_t> rangeMask(const Date& from, const Date& to) const;
+    int dayOfTerm(const Date& date) const;  // -1 outside the term
+};
+
+#endif // ATTENDANCEBITMAPINDEX_H
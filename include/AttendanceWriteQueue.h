@@ -0,0 +1,66 @@
+#ifndef ATTENDANCEWRITEQUEUE_H
+#define ATTENDANCEWRITEQUEUE_H
+
+#include "ConnectionPool.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Group-commit pipeline for single attendance marks. Request threads push
+// onto a lock-free multi-producer queue; one writer thread waits up to
+// maxDelay for up to maxBatch marks and commits them together with
+// Database::markAttendanceBatch, so many marks share one transaction and
+// one redo-log flush. Every caller still gets its own result.
+class AttendanceWriteQueue {
+public:
+    AttendanceWriteQueue(ConnectionPool& pool, size_t maxBatch, chrono::milliseconds maxDelay);
+    // Commits everything already queued, then stops the writer
+    ~AttendanceWriteQueue();
+
+    AttendanceWriteQueue(const AttendanceWriteQueue&) = delete;
+    AttendanceWriteQueue& operator=(const AttendanceWriteQueue&) = delete;
+
+    // Never blocks; the future resolves once the mark's batch has committed
+    future<MarkAttendanceResult> submit(AttendanceEntry entry);
+
+    size_t depth() const { return pending.load(memory_order_relaxed); }
+
+private:
+    struct Node {
+        atomic<Node*> next{nullptr};
+        AttendanceEntry entry;
+        promise<MarkAttendanceResult> result;
+    };
+
+    ConnectionPool& pool;
+    const size_t maxBatch;
+    const chrono::milliseconds maxDelay;
+
+    // Intrusive MPSC queue (Vyukov): producers exchange the head, only the
+    // writer thread touches tail. The stub keeps the list non-empty.
+    atomic<Node*> head;
+    Node* tail;
+    Node stub;
+
+    // Marks pushed but not yet taken by the writer. The mutex is only used to
+    // put the idle writer to sleep; producers take it just to wake it.
+    atomic<size_t> pending;
+    mutex wakeMutex;
+    condition_variable wake;
+    bool stopping;
+
+    thread writer;
+
+    void push(Node* node);
+    Node* pop();
+    void run();
+    void commit(vector<Node*>& batch);
+};
+
+#endif // ATTENDANCEWRITEQUEUE_H
@@ -12,7 +12,7 @@ protected:
     string getInput(const string& prompt);
     int getIntInput(const string& prompt);
     double getDoubleInput(const string& prompt);
-    string getDate(const string& prompt);
+    Date getDate(const string& prompt);  // re-prompts until the date exists
     
 public:
     BaseController(Database* database);
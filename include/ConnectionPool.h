@@ -0,0 +1,74 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include "Database.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+// Fixed-bounds pool of Database connections shared by the API worker threads.
+// Each Database owns its own MYSQL handle, so leased connections can run
+// queries concurrently without any global lock.
+class ConnectionPool {
+public:
+    // RAII handle returned by acquire(); gives the connection back on destruction
+    class Lease {
+    private:
+        ConnectionPool* pool;
+        Database* conn;
+
+    public:
+        Lease() : pool(nullptr), conn(nullptr) {}
+        Lease(ConnectionPool* owner, Database* connection) : pool(owner), conn(connection) {}
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        Database* get() const { return conn; }
+        Database* operator->() const { return conn; }
+        explicit operator bool() const { return conn != nullptr; }
+
+        void release();
+    };
+
+    // Reads pool_min_size, pool_max_size and pool_timeout_ms from config;
+    // the remaining keys are passed through to every Database connection.
+    ConnectionPool(const map<string, string>& config);
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Blocks for at most the configured timeout; returns an empty lease on timeout
+    Lease acquire();
+
+    size_t size() const;
+    size_t idleCount() const;
+    size_t minSize() const { return minConnections; }
+    size_t maxSize() const { return maxConnections; }
+    bool isConnected() const;
+
+private:
+    map<string, string> connectionConfig;
+    size_t minConnections;
+    size_t maxConnections;
+    chrono::milliseconds acquireTimeout;
+
+    mutable mutex poolMutex;
+    condition_variable connectionReturned;
+    vector<unique_ptr<Database>> connections;  // every connection the pool owns
+    vector<Database*> idle;                     // subset currently available
+    size_t pendingConnects;                     // slots reserved while connecting
+
+    void giveBack(Database* conn);
+};
+
+#endif // CONNECTIONPOOL_H
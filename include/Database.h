@@ -1,92 +1,157 @@
 #ifndef DATABASE_H
 #define DATABASE_H
 
-#include <mysql/mysql.h>
+#include "Models.h"
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
 
 using namespace std;
 
+// Outcome of Database::markAttendanceChecked
+enum class MarkAttendanceResult {
+    Marked,
+    StudentNotFound,
+    StudentHasNoClass,
+    SubjectNotInClass,
+    StudentNotInClass,  // not in the class the entry was restricted to
+    AlreadyMarked,
+    Failed
+};
+
+// One student's entry in a bulk marking request
+struct AttendanceMark {
+    int studentId;
+    string status;
+};
+
+// One mark in a batch that may span subjects and dates
+struct AttendanceEntry {
+    int studentId;
+    int subjectId;
+    Date date;
+    string status;
+    int classId = 0;    // if set, only a student of this class may be marked
+};
+
+// Storage backend used by the CLI controllers and the API server.
+// MySqlDatabase is the production implementation; MemoryDatabase keeps the
+// same tables, unique keys and cascades in process, so handlers can be
+// benchmarked and load tested without a MySQL server.
 class Database {
-private:
-    MYSQL* conn;
-    map<string, string> connectionConfig;
-    
-    // Helper method for connection management
-    bool reconnect();
-    bool ensureConnection();
-    
 public:
-    Database(const map<string, string>& config);
-    ~Database();
-    
-    bool isConnected() const;
-    
+    virtual ~Database() = default;
+
+    // Backend named by the "storage" config key: "mysql" (default) or "memory"
+    static unique_ptr<Database> create(const map<string, string>& config);
+
+    virtual bool isConnected() const = 0;
+    // Whether the last query on this connection failed. The list getters
+    // return an empty container on error; this tells the two apart.
+    virtual bool lastQueryFailed() const = 0;
+
     // Authentication
-    bool authenticateAdmin(const string& email, const string& password);
-    map<string, string> authenticateTeacher(const string& email, const string& password);
-    
+    virtual bool authenticateAdmin(const string& email, const string& password) = 0;
+    virtual optional<Teacher> authenticateTeacher(const string& email, const string& password) = 0;
+
     // CRUD - Subjects
-    int createSubject(const string& name, int maxMarks);
-    vector<map<string, string>> getAllSubjects();
-    map<string, string> getSubjectById(int id);
-    
+    virtual int createSubject(const string& name, int maxMarks) = 0;
+    virtual vector<Subject> getAllSubjects() = 0;
+    virtual optional<Subject> getSubjectById(int id) = 0;
+
     // CRUD - Classes
-    int createClass(const string& className);
-    vector<map<string, string>> getAllClasses();
-    map<string, string> getClassById(int id);
-    
+    virtual int createClass(const string& className) = 0;
+    virtual vector<ClassInfo> getAllClasses() = 0;
+    virtual optional<ClassInfo> getClassById(int id) = 0;
+
     // CRUD - Teachers
-    int createTeacher(const string& name, const string& email, 
-                     const string& password, double salary, 
-                     const string& joinDate, const string& type);
-    vector<map<string, string>> getAllTeachers();
-    std::vector<std::map<std::string, std::string>> getAllTeachersWithDetails(); // Optimized fetch
-    map<string, string> getTeacherById(int id);
-    map<string, string> getTeacherClassAssignment(int teacherId);
-    vector<map<string, string>> getTeacherSubjectAssignments(int teacherId);
-    
+    virtual int createTeacher(const string& name, const string& email,
+                              const string& password, double salary,
+                              const Date& joinDate, const string& type) = 0;
+    virtual vector<Teacher> getAllTeachers() = 0;
+    virtual vector<Teacher> getAllTeachersWithDetails() = 0; // Includes class teacher assignment
+    virtual optional<Teacher> getTeacherById(int id) = 0;
+    virtual optional<ClassInfo> getTeacherClassAssignment(int teacherId) = 0;
+    virtual vector<Assignment> getTeacherSubjectAssignments(int teacherId) = 0;
+    virtual unordered_map<int, vector<Assignment>> getAllTeacherSubjectAssignments() = 0;  // teacher id -> assignments
+
     // Teacher assignments
-    bool assignClassTeacher(int classId, int teacherId);
-    bool assignSubjectTeacher(int teacherId, int subjectId, int classId);
-    
+    virtual bool assignClassTeacher(int classId, int teacherId) = 0;
+    virtual bool assignSubjectTeacher(int teacherId, int subjectId, int classId) = 0;
+
     // CRUD - Students
-    int createStudent(const string& name, int classId);
-    vector<map<string, string>> getAllStudents();
-    map<string, string> getStudentById(int id);
-    vector<map<string, string>> getStudentsByClass(int classId);
-    bool updateStudentName(int studentId, const string& newName);
-    
+    virtual int createStudent(const string& name, int classId) = 0;
+    virtual vector<Student> getAllStudents() = 0;
+    // Keyset page ordered by id: at most `limit` students with id > afterId
+    virtual vector<Student> getStudentsPage(int afterId, int limit) = 0;
+    virtual int countStudents() = 0;  // -1 on error
+    virtual optional<Student> getStudentById(int id) = 0;
+    virtual vector<Student> getStudentsByClass(int classId) = 0;
+    virtual bool updateStudentName(int studentId, const string& newName) = 0;
+
     // Delete operations
-    bool deleteSubject(int subjectId);
-    bool deleteClass(int classId);
-    bool deleteTeacher(int teacherId);
-    bool deleteStudent(int studentId);
-    
+    virtual bool deleteSubject(int subjectId) = 0;
+    virtual bool deleteClass(int classId) = 0;
+    virtual bool deleteTeacher(int teacherId) = 0;
+    virtual bool deleteStudent(int studentId) = 0;
+
     // Validation operations
-    bool classExists(int classId);
-    bool subjectExists(int subjectId);
-    bool teacherExists(int teacherId);
-    bool studentExists(int studentId);
-    bool isClassNameUnique(const string& className);
-    bool isSubjectNameUnique(const string& subjectName);
-    bool isAttendanceMarked(int studentId, int subjectId, const string& date);
-    bool isSubjectInClass(int subjectId, int classId);
-    
+    virtual bool classExists(int classId) = 0;
+    virtual bool subjectExists(int subjectId) = 0;
+    virtual bool teacherExists(int teacherId) = 0;
+    virtual bool studentExists(int studentId) = 0;
+    virtual bool isClassNameUnique(const string& className) = 0;
+    virtual bool isSubjectNameUnique(const string& subjectName) = 0;
+    virtual bool isAttendanceMarked(int studentId, int subjectId, const Date& date) = 0;
+    virtual bool isSubjectInClass(int subjectId, int classId) = 0;
+
     // Attendance operations
-    bool markAttendance(int studentId, int subjectId, int classId, 
-                       const string& date, const string& status);
-    vector<map<string, string>> getStudentAttendance(int studentId);
-    vector<map<string, string>> getClassAttendance(int classId);
-    double getAttendancePercentage(int studentId, int subjectId);
-    
+    virtual bool markAttendance(int studentId, int subjectId, int classId,
+                                const Date& date, const string& status) = 0;
+    // Validates the student's class, the subject-in-class rule and duplicates
+    virtual MarkAttendanceResult markAttendanceChecked(int studentId, int subjectId,
+                                                       const Date& date, const string& status) = 0;
+    // Marks a whole session atomically. Results follow input order. A
+    // non-zero classId rejects students outside that class.
+    virtual vector<MarkAttendanceResult> markAttendanceBulk(int subjectId, const Date& date,
+                                                            const vector<AttendanceMark>& marks,
+                                                            int classId) = 0;
+    // General form of markAttendanceBulk used by the group-commit writer:
+    // any mix of students, subjects and dates, committed together
+    virtual vector<MarkAttendanceResult> markAttendanceBatch(const vector<AttendanceEntry>& entries) = 0;
+    virtual vector<AttendanceRecord> getStudentAttendance(int studentId) = 0;
+    // Newest first, at most `limit` records across all subjects
+    virtual vector<AttendanceRecord> getRecentAttendance(int studentId, int limit) = 0;
+    virtual vector<AttendanceRecord> getClassAttendance(int classId) = 0;
+
+    // Streaming variants: each row is handed to the visitor in order instead
+    // of building the whole result. Return false from the visitor to stop
+    // early. Visitors must not call back into this Database.
+    using AttendanceVisitor = function<bool(const AttendanceRecord&)>;
+    virtual bool forEachStudentAttendance(int studentId, const AttendanceVisitor& visitor) = 0;
+    virtual bool forEachClassAttendance(int classId, const AttendanceVisitor& visitor) = 0;
+    // Keyset page of a class's attendance in (date, student, subject) order,
+    // resuming after that key of `after` (from the start if its date is not
+    // valid). Buffered, so the connection is free again once this returns.
+    virtual vector<AttendanceRecord> getClassAttendancePage(int classId, const AttendanceRecord& after,
+                                                            int limit) = 0;
+    // From the per-(student, subject) counters: one subject, or overall when
+    // subjectId is 0
+    virtual double getAttendancePercentage(int studentId, int subjectId) = 0;
+    virtual vector<AttendanceSummary> getAttendanceSummary(int studentId) = 0;
+    // Recomputes the counters from the raw attendance records
+    virtual bool rebuildAttendanceSummary() = 0;
+    // Every student in the class with their mark (if any) for one session
+    virtual vector<SessionSheetEntry> getClassSessionSheet(int classId, int subjectId, const Date& date) = 0;
+
     // Class-Subject operations
-    bool addSubjectToClass(int classId, int subjectId);
-    vector<map<string, string>> getClassSubjects(int classId);
-    
-    // Helper methods
-    string escapeString(const string& str);
+    virtual bool addSubjectToClass(int classId, int subjectId) = 0;
+    virtual vector<Subject> getClassSubjects(int classId) = 0;
+    virtual unordered_map<int, vector<Subject>> getAllClassSubjects() = 0;  // class id -> subjects
 };
 
 #endif // DATABASE_H
@@ -0,0 +1,35 @@
+#ifndef HTTPCOMPRESSION_H
+#define HTTPCOMPRESSION_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Content-coding negotiation and zlib compression for HTTP responses
+enum class ContentEncoding : uint8_t {
+    Identity,
+    Gzip,
+    Deflate     // zlib stream, as HTTP's "deflate" is defined
+};
+
+const char* toString(ContentEncoding encoding);
+
+// Best coding an Accept-Encoding header allows, honouring q-values;
+// gzip wins ties. Identity if the header is empty or allows neither.
+ContentEncoding negotiateEncoding(const string& acceptEncoding);
+
+// True for text-like types (text/*, JSON, JavaScript, SVG, XML)
+bool isCompressibleType(const string& contentType);
+
+// Compresses `size` bytes into `out`; false if zlib fails
+bool compressBody(const char* data, size_t size, ContentEncoding encoding, int level, string& out);
+
+// A strong ETag must differ per coding: "abc" -> "abc+gzip"
+string encodedEtag(const string& etag, ContentEncoding encoding);
+
+// True if an If-None-Match value lists `etag` in any coding (or is "*").
+// If-None-Match uses weak comparison, so W/ prefixes are ignored.
+bool etagMatches(const string& ifNoneMatch, const string& etag);
+
+#endif // HTTPCOMPRESSION_H
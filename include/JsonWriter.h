@@ -0,0 +1,56 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Writes JSON text straight into a caller-owned string, for responses with
+// many rows. Unlike building an nlohmann::json tree and dumping it, nothing
+// is allocated per field: values are appended as they are written, and a
+// buffer reused across calls stops growing once it fits the largest output.
+// Commas and colons are inserted automatically; nesting is limited to 64.
+//
+//   JsonWriter out(buffer);
+//   out.beginObject().field("id", 7).key("tags").beginArray().value("a").endArray().endObject();
+class JsonWriter {
+public:
+    explicit JsonWriter(string& out) : out(out) {}
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    // Inside an object: the name of the next value
+    JsonWriter& key(const char* name);
+
+    JsonWriter& value(const string& text) { return value(text.data(), text.size()); }
+    JsonWriter& value(const char* text);
+    JsonWriter& value(const char* text, size_t length);
+    JsonWriter& value(int number) { return value(static_cast<int64_t>(number)); }
+    JsonWriter& value(int64_t number);
+    JsonWriter& value(double number);     // non-finite numbers are written as null
+    JsonWriter& value(bool flag);
+    JsonWriter& null();
+
+    template <typename T>
+    JsonWriter& field(const char* name, const T& v) {
+        key(name);
+        return value(v);
+    }
+
+private:
+    string& out;
+    uint64_t hasItems = 0;   // bit d: the container at depth d already has an item
+    int depth = 0;
+    bool afterKey = false;
+
+    void separate();
+    void open(char bracket);
+    void close(char bracket);
+    void appendString(const char* text, size_t length);
+};
+
+#endif // JSONWRITER_H
@@ -0,0 +1,171 @@
+#ifndef MEMORYDATABASE_H
+#define MEMORYDATABASE_H
+
+#include "Database.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <shared_mutex>
+#include <tuple>
+
+using namespace std;
+
+// Database kept entirely in process memory. It mirrors database.sql and the
+// migrations: auto-increment ids, the same unique keys (compared
+// case-insensitively, like MySQL's default collation), foreign key checks
+// on insert, and ON DELETE CASCADE / SET NULL on delete. Several
+// MemoryDatabase objects may share one Store, the way pooled MySQL
+// connections share one server.
+class MemoryDatabase : public Database {
+public:
+    struct Store;
+
+    // A fresh store seeded with database.sql's default admin
+    MemoryDatabase();
+    explicit MemoryDatabase(shared_ptr<Store> store);
+
+    static shared_ptr<Store> createStore();
+
+    bool isConnected() const override { return true; }
+    bool lastQueryFailed() const override { return false; }
+
+    // Authentication
+    bool authenticateAdmin(const string& email, const string& password) override;
+    optional<Teacher> authenticateTeacher(const string& email, const string& password) override;
+
+    // CRUD - Subjects
+    int createSubject(const string& name, int maxMarks) override;
+    vector<Subject> getAllSubjects() override;
+    optional<Subject> getSubjectById(int id) override;
+
+    // CRUD - Classes
+    int createClass(const string& className) override;
+    vector<ClassInfo> getAllClasses() override;
+    optional<ClassInfo> getClassById(int id) override;
+
+    // CRUD - Teachers
+    int createTeacher(const string& name, const string& email,
+                     const string& password, double salary,
+                     const Date& joinDate, const string& type) override;
+    vector<Teacher> getAllTeachers() override;
+    vector<Teacher> getAllTeachersWithDetails() override;
+    optional<Teacher> getTeacherById(int id) override;
+    optional<ClassInfo> getTeacherClassAssignment(int teacherId) override;
+    vector<Assignment> getTeacherSubjectAssignments(int teacherId) override;
+    unordered_map<int, vector<Assignment>> getAllTeacherSubjectAssignments() override;
+
+    // Teacher assignments
+    bool assignClassTeacher(int classId, int teacherId) override;
+    bool assignSubjectTeacher(int teacherId, int subjectId, int classId) override;
+
+    // CRUD - Students
+    int createStudent(const string& name, int classId) override;
+    vector<Student> getAllStudents() override;
+    vector<Student> getStudentsPage(int afterId, int limit) override;
+    int countStudents() override;
+    optional<Student> getStudentById(int id) override;
+    vector<Student> getStudentsByClass(int classId) override;
+    bool updateStudentName(int studentId, const string& newName) override;
+
+    // Delete operations
+    bool deleteSubject(int subjectId) override;
+    bool deleteClass(int classId) override;
+    bool deleteTeacher(int teacherId) override;
+    bool deleteStudent(int studentId) override;
+
+    // Validation operations
+    bool classExists(int classId) override;
+    bool subjectExists(int subjectId) override;
+    bool teacherExists(int teacherId) override;
+    bool studentExists(int studentId) override;
+    bool isClassNameUnique(const string& className) override;
+    bool isSubjectNameUnique(const string& subjectName) override;
+    bool isAttendanceMarked(int studentId, int subjectId, const Date& date) override;
+    bool isSubjectInClass(int subjectId, int classId) override;
+
+    // Attendance operations
+    bool markAttendance(int studentId, int subjectId, int classId,
+                       const Date& date, const string& status) override;
+    MarkAttendanceResult markAttendanceChecked(int studentId, int subjectId,
+                                               const Date& date, const string& status) override;
+    vector<MarkAttendanceResult> markAttendanceBulk(int subjectId, const Date& date,
+                                                    const vector<AttendanceMark>& marks,
+                                                    int classId) override;
+    vector<MarkAttendanceResult> markAttendanceBatch(const vector<AttendanceEntry>& entries) override;
+    vector<AttendanceRecord> getStudentAttendance(int studentId) override;
+    vector<AttendanceRecord> getRecentAttendance(int studentId, int limit) override;
+    vector<AttendanceRecord> getClassAttendance(int classId) override;
+
+    // Rows are copied out under the store's lock, then visited without it
+    bool forEachStudentAttendance(int studentId, const AttendanceVisitor& visitor) override;
+    bool forEachClassAttendance(int classId, const AttendanceVisitor& visitor) override;
+    vector<AttendanceRecord> getClassAttendancePage(int classId, const AttendanceRecord& after,
+                                                    int limit) override;
+    double getAttendancePercentage(int studentId, int subjectId) override;
+    vector<AttendanceSummary> getAttendanceSummary(int studentId) override;
+    bool rebuildAttendanceSummary() override;
+    vector<SessionSheetEntry> getClassSessionSheet(int classId, int subjectId, const Date& date) override;
+
+    // Class-Subject operations
+    bool addSubjectToClass(int classId, int subjectId) override;
+    vector<Subject> getClassSubjects(int classId) override;
+    unordered_map<int, vector<Subject>> getAllClassSubjects() override;
+
+private:
+    shared_ptr<Store> store;
+};
+
+// The tables. std::map keeps rows in primary key order, as InnoDB does.
+struct MemoryDatabase::Store {
+    struct AdminRow {
+        string email;
+        string password;
+    };
+
+    struct TeacherRow {
+        Teacher teacher;    // classId/className unused here
+        string password;
+    };
+
+    struct StudentRow {
+        string name;
+        int classId = 0;    // 0 for NULL
+    };
+
+    struct AttendanceRow {
+        int attendanceId = 0;
+        int classId = 0;
+        string status;
+    };
+
+    struct Counters {
+        int total = 0;
+        int present = 0;
+    };
+
+    // Readers share the lock; every write takes it exclusively, which makes
+    // each call (including batches) atomic like a MySQL transaction
+    shared_mutex lock;
+
+    map<int, AdminRow> admins;
+    map<int, TeacherRow> teachers;
+    map<int, ClassInfo> classes;
+    map<int, Subject> subjects;
+    map<int, StudentRow> students;
+    map<int, int> classTeachers;                    // class id -> teacher id (class_id UNIQUE)
+    set<tuple<int, int, int>> subjectTeachers;      // (teacher, subject, class)
+    set<pair<int, int>> classSubjects;              // (class, subject)
+    // unique_attendance (student, subject, date), date as days since epoch
+    map<tuple<int, int, int32_t>, AttendanceRow> attendance;
+    map<pair<int, int>, Counters> summary;          // (student, subject)
+
+    int nextAdminId = 1;
+    int nextTeacherId = 1;
+    int nextClassId = 1;
+    int nextSubjectId = 1;
+    int nextStudentId = 1;
+    int nextAttendanceId = 1;
+};
+
+#endif // MEMORYDATABASE_H
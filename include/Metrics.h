@@ -0,0 +1,120 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Lock-free metrics for the API server, rendered in the Prometheus text
+// format. Recording is relaxed atomic adds on one of several cache-line
+// sized shards picked per thread, so workers never contend on a line.
+
+constexpr size_t metricShards = 16;
+
+class Counter {
+public:
+    void add(uint64_t n = 1);
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Shard {
+        atomic<uint64_t> value{0};
+    };
+    Shard shards[metricShards];
+};
+
+// Latency histogram with power-of-two buckets: bucket i holds observations
+// of at most 2^i microseconds (1 us to about 8.4 s), then +Inf
+class Histogram {
+public:
+    static constexpr int bucketCount = 24;
+
+    struct Snapshot {
+        uint64_t buckets[bucketCount + 1] = {};   // not cumulative
+        uint64_t count = 0;
+        double sumSeconds = 0.0;
+    };
+
+    void observe(chrono::nanoseconds elapsed);
+    Snapshot snapshot() const;
+
+private:
+    struct alignas(64) Shard {
+        atomic<uint64_t> buckets[bucketCount + 1] = {};
+        atomic<uint64_t> sumNanos{0};
+    };
+    Shard shards[metricShards];
+};
+
+// Histograms with up to two labels, created on first use. Lookups and
+// inserts go through a fixed open-addressed table of atomic pointers, so
+// neither takes a lock; label sets past its capacity share one "other" series.
+class HistogramFamily {
+public:
+    HistogramFamily(const string& name, const string& help, const string& label1, const string& label2 = "");
+    ~HistogramFamily();
+
+    HistogramFamily(const HistogramFamily&) = delete;
+    HistogramFamily& operator=(const HistogramFamily&) = delete;
+
+    Histogram& get(const string& value1, const string& value2 = "");
+
+    void render(string& out) const;
+
+private:
+    struct Series {
+        string value1;
+        string value2;
+        string labels;      // rendered: name="value",...
+        Histogram histogram;
+    };
+
+    static constexpr size_t capacity = 512;
+
+    string name;
+    string help;
+    string label1;
+    string label2;
+    atomic<Series*> slots[capacity];
+    unique_ptr<Series> overflow;
+
+    unique_ptr<Series> makeSeries(const string& value1, const string& value2) const;
+};
+
+// Everything GET /metrics reports. Register metrics at startup, before
+// any worker thread records into them; render() may run concurrently
+// with recording.
+class MetricsRegistry {
+public:
+    Counter& counter(const string& name, const string& help);
+    HistogramFamily& histograms(const string& name, const string& help,
+                                const string& label1, const string& label2 = "");
+    Histogram& histogram(const string& name, const string& help);
+    // Sampled when rendered
+    void gauge(const string& name, const string& help, function<double()> read);
+    void counterFunction(const string& name, const string& help, function<double()> read);
+
+    string render() const;
+
+private:
+    struct Entry {
+        string name;
+        string help;
+        const char* type;
+        unique_ptr<Counter> counter;
+        unique_ptr<HistogramFamily> family;
+        function<double()> read;
+    };
+    vector<unique_ptr<Entry>> entries;
+};
+
+// Prometheus label value escaping
+string escapeLabelValue(const string& value);
+
+#endif // METRICS_H
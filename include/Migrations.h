@@ -0,0 +1,31 @@
+#ifndef MIGRATIONS_H
+#define MIGRATIONS_H
+
+#include "MySqlDatabase.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A numbered schema change applied on top of database.sql (version 0).
+// Versions must be strictly increasing; never edit one that has shipped.
+struct Migration {
+    int version;
+    string description;
+    vector<string> statements;
+};
+
+class Migrations {
+public:
+    static const vector<Migration>& all();
+
+    // Applies every migration newer than the recorded schema version, in order.
+    // Stops at the first failure and returns false.
+    static bool run(MySqlDatabase& db);
+
+    // EXPLAINs the hot queries issued by MySqlDatabase and reports any step that
+    // would scan a whole table. Returns false if any does.
+    static bool checkQueryPlans(MySqlDatabase& db);
+};
+
+#endif // MIGRATIONS_H
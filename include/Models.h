@@ -0,0 +1,228 @@
+#ifndef MODELS_H
+#define MODELS_H
+
+#include <climits>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+enum class Weekday : uint8_t {
+    Monday,
+    Tuesday,
+    Wednesday,
+    Thursday,
+    Friday,
+    Saturday,
+    Sunday
+};
+
+// Calendar date as a day count since 1970-01-01 (proleptic Gregorian), so
+// comparing, sorting, range checks and bucketing are integer operations.
+// The text form is MySQL's "YYYY-MM-DD"; parsing and formatting handle only
+// that form, need no locale and work at compile time. A default-constructed
+// Date is invalid.
+class Date {
+public:
+    constexpr Date() = default;
+
+    static constexpr Date fromDays(int32_t days) {
+        Date date;
+        date.days = days;
+        return date;
+    }
+
+    // Invalid unless the year is 1-9999 and the day exists in that month
+    static constexpr Date fromCivil(int year, int month, int day) {
+        if (year < 1 || year > 9999 || month < 1 || month > 12) return Date();
+        if (day < 1 || day > daysInMonth(year, month)) return Date();
+        return fromDays(daysFromCivil(year, month, day));
+    }
+
+    // Invalid if text is not a real YYYY-MM-DD date (so 2025-02-30 fails)
+    static constexpr Date parse(const char* text, size_t length) {
+        if (text == nullptr || length != 10 || text[4] != '-' || text[7] != '-') return Date();
+        return fromCivil(digits(text, 4), digits(text + 5, 2), digits(text + 8, 2));
+    }
+    static Date parse(const string& text) { return parse(text.data(), text.size()); }
+
+    static Date today();  // local time
+
+    constexpr bool isValid() const { return days != invalidDays; }
+    constexpr int32_t daysSinceEpoch() const { return days; }
+
+    constexpr int year() const { return civil(days).year; }
+    constexpr int month() const { return civil(days).month; }
+    constexpr int day() const { return civil(days).day; }
+    constexpr Weekday weekday() const {
+        // 1970-01-01 was a Thursday
+        return static_cast<Weekday>(((days % 7) + 10) % 7);
+    }
+
+    // Range helpers
+    constexpr Date addDays(int count) const { return isValid() ? fromDays(days + count) : Date(); }
+    constexpr int daysUntil(const Date& other) const { return other.days - days; }
+    constexpr bool between(const Date& first, const Date& last) const {
+        return isValid() && first.days <= days && days <= last.days;
+    }
+    constexpr Date startOfWeek() const {
+        return isValid() ? fromDays(days - static_cast<int>(weekday())) : Date();
+    }
+    constexpr Date startOfMonth() const {
+        return isValid() ? fromDays(days - day() + 1) : Date();
+    }
+
+    // Writes exactly 10 characters (no terminator); "0000-00-00" if invalid
+    constexpr void format(char* out) const {
+        Civil c = isValid() ? civil(days) : Civil{0, 0, 0};
+        out[0] = static_cast<char>('0' + (c.year / 1000) % 10);
+        out[1] = static_cast<char>('0' + (c.year / 100) % 10);
+        out[2] = static_cast<char>('0' + (c.year / 10) % 10);
+        out[3] = static_cast<char>('0' + c.year % 10);
+        out[4] = '-';
+        out[5] = static_cast<char>('0' + c.month / 10);
+        out[6] = static_cast<char>('0' + c.month % 10);
+        out[7] = '-';
+        out[8] = static_cast<char>('0' + c.day / 10);
+        out[9] = static_cast<char>('0' + c.day % 10);
+    }
+    string toString() const;
+
+    constexpr bool operator==(const Date& other) const { return days == other.days; }
+    constexpr bool operator!=(const Date& other) const { return days != other.days; }
+    constexpr bool operator<(const Date& other) const { return days < other.days; }
+    constexpr bool operator<=(const Date& other) const { return days <= other.days; }
+    constexpr bool operator>(const Date& other) const { return days > other.days; }
+    constexpr bool operator>=(const Date& other) const { return days >= other.days; }
+
+private:
+    struct Civil {
+        int year;
+        int month;
+        int day;
+    };
+
+    static constexpr int32_t invalidDays = INT32_MIN;
+    int32_t days = invalidDays;
+
+    // Value of `count` ASCII digits, or -1
+    static constexpr int digits(const char* text, int count) {
+        int value = 0;
+        for (int i = 0; i < count; ++i) {
+            if (text[i] < '0' || text[i] > '9') return -1;
+            value = value * 10 + (text[i] - '0');
+        }
+        return value;
+    }
+
+    static constexpr int daysInMonth(int year, int month) {
+        if (month == 2) {
+            bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+            return leap ? 29 : 28;
+        }
+        return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+    }
+
+    // Howard Hinnant's days_from_civil / civil_from_days; years here are
+    // always positive, so the eras need no negative rounding
+    static constexpr int32_t daysFromCivil(int year, int month, int day) {
+        year -= month <= 2 ? 1 : 0;
+        int era = year / 400;
+        int yearOfEra = year - era * 400;
+        int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    static constexpr Civil civil(int32_t days) {
+        int z = days + 719468;
+        int era = z / 146097;
+        int dayOfEra = z - era * 146097;
+        int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        int mp = (5 * dayOfYear + 2) / 153;
+        int month = mp < 10 ? mp + 3 : mp - 9;
+        int day = dayOfYear - (153 * mp + 2) / 5 + 1;
+        return {yearOfEra + era * 400 + (month <= 2 ? 1 : 0), month, day};
+    }
+};
+
+enum class AttendanceStatus : uint8_t {
+    Unknown,
+    Present,
+    Absent,
+    Late
+};
+
+// Case-insensitive; anything unrecognised maps to Unknown
+AttendanceStatus parseAttendanceStatus(const string& text);
+const char* toString(AttendanceStatus status);
+
+// Typed rows returned by Database. An id of 0 means "none" (e.g. a student
+// without a class), mirroring the NULL foreign keys in the schema.
+struct Subject {
+    int id = 0;
+    string name;
+    int maxMarks = 0;
+};
+
+struct ClassInfo {
+    int id = 0;
+    string name;
+};
+
+struct Student {
+    int id = 0;
+    string name;
+    int classId = 0;
+    string className;
+};
+
+struct Teacher {
+    int id = 0;
+    string name;
+    string email;
+    double salary = 0.0;
+    Date joinDate;
+    string type;        // "ClassTeacher" or "SubjectTeacher"
+    int classId = 0;    // class teacher assignment, if loaded
+    string className;
+};
+
+// A subject a teacher teaches in a specific class
+struct Assignment {
+    int subjectId = 0;
+    string subjectName;
+    int classId = 0;
+    string className;
+};
+
+struct AttendanceRecord {
+    int studentId = 0;
+    int subjectId = 0;
+    Date date;
+    AttendanceStatus status = AttendanceStatus::Unknown;
+    string studentName;   // filled by class-wide queries
+    string subjectName;
+};
+
+// One student's line on a class session sheet (class + subject + date)
+struct SessionSheetEntry {
+    int studentId = 0;
+    string studentName;
+    bool marked = false;  // false when the student has no record for the session
+    AttendanceStatus status = AttendanceStatus::Unknown;
+};
+
+// Running counters for one (student, subject) pair, kept in attendance_summary
+struct AttendanceSummary {
+    int studentId = 0;
+    int subjectId = 0;
+    string subjectName;
+    int total = 0;
+    int present = 0;
+
+    double percentage() const { return total > 0 ? (present * 100.0) / total : 0.0; }
+};
+
+#endif // MODELS_H
@@ -0,0 +1,156 @@
+#ifndef MYSQLDATABASE_H
+#define MYSQLDATABASE_H
+
+#include "Database.h"
+#include <atomic>
+#include <mysql/mysql.h>
+
+using namespace std;
+
+// Database backed by one libmysqlclient connection
+class MySqlDatabase : public Database {
+private:
+    MYSQL* conn;
+    map<string, string> connectionConfig;
+
+    // Prepared statements for the hot queries, keyed by the address of their
+    // static SQL text. Owned by (and only valid for) the current conn.
+    unordered_map<const char*, MYSQL_STMT*> statements;
+
+    // Helper method for connection management
+    static atomic<uint64_t> reconnectCount;
+    bool reconnect();
+    bool ensureConnection();
+
+    // Prepared statement helpers
+    MYSQL_STMT* prepareStatement(const char* sql);
+    bool executeStatement(MYSQL_STMT* stmt, MYSQL_BIND* params, MYSQL_BIND* results,
+                          bool buffered = true);
+    void closeStatements();
+
+    // Transactions on the text protocol; rollback is best effort
+    bool beginTransaction();
+    bool commitTransaction();
+    void rollbackTransaction();
+
+    // Adds one mark to the student's attendance_summary row; call inside
+    // the transaction that inserted the attendance record
+    bool bumpAttendanceSummary(int studentId, int subjectId, bool present);
+
+    // One attempt at markAttendanceBatch. Fills in each entry's outcome
+    // (Marked for the rows it tried to insert) and returns 0 once committed,
+    // otherwise the MySQL error that rolled the transaction back.
+    unsigned tryMarkAttendanceBatch(const vector<AttendanceEntry>& entries,
+                                    vector<MarkAttendanceResult>& results);
+    // tryMarkAttendanceBatch, repeated on deadlock or lock wait timeout
+    unsigned markAttendanceBatchWithRetry(const vector<AttendanceEntry>& entries,
+                                          vector<MarkAttendanceResult>& results);
+
+    string escapeString(const string& str);
+
+public:
+    MySqlDatabase(const map<string, string>& config);
+    ~MySqlDatabase() override;
+
+    bool isConnected() const override;
+    bool lastQueryFailed() const override;
+
+    // Reconnects after a lost connection, across all instances
+    static uint64_t reconnects() { return reconnectCount.load(memory_order_relaxed); }
+
+    // Authentication
+    bool authenticateAdmin(const string& email, const string& password) override;
+    optional<Teacher> authenticateTeacher(const string& email, const string& password) override;
+
+    // CRUD - Subjects
+    int createSubject(const string& name, int maxMarks) override;
+    vector<Subject> getAllSubjects() override;
+    optional<Subject> getSubjectById(int id) override;
+
+    // CRUD - Classes
+    int createClass(const string& className) override;
+    vector<ClassInfo> getAllClasses() override;
+    optional<ClassInfo> getClassById(int id) override;
+
+    // CRUD - Teachers
+    int createTeacher(const string& name, const string& email,
+                     const string& password, double salary,
+                     const Date& joinDate, const string& type) override;
+    vector<Teacher> getAllTeachers() override;
+    vector<Teacher> getAllTeachersWithDetails() override;
+    optional<Teacher> getTeacherById(int id) override;
+    optional<ClassInfo> getTeacherClassAssignment(int teacherId) override;
+    vector<Assignment> getTeacherSubjectAssignments(int teacherId) override;
+    unordered_map<int, vector<Assignment>> getAllTeacherSubjectAssignments() override;
+
+    // Teacher assignments
+    bool assignClassTeacher(int classId, int teacherId) override;
+    bool assignSubjectTeacher(int teacherId, int subjectId, int classId) override;
+
+    // CRUD - Students
+    int createStudent(const string& name, int classId) override;
+    vector<Student> getAllStudents() override;
+    vector<Student> getStudentsPage(int afterId, int limit) override;
+    int countStudents() override;
+    optional<Student> getStudentById(int id) override;
+    vector<Student> getStudentsByClass(int classId) override;
+    bool updateStudentName(int studentId, const string& newName) override;
+
+    // Delete operations
+    bool deleteSubject(int subjectId) override;
+    bool deleteClass(int classId) override;
+    bool deleteTeacher(int teacherId) override;
+    bool deleteStudent(int studentId) override;
+
+    // Validation operations
+    bool classExists(int classId) override;
+    bool subjectExists(int subjectId) override;
+    bool teacherExists(int teacherId) override;
+    bool studentExists(int studentId) override;
+    bool isClassNameUnique(const string& className) override;
+    bool isSubjectNameUnique(const string& subjectName) override;
+    bool isAttendanceMarked(int studentId, int subjectId, const Date& date) override;
+    bool isSubjectInClass(int subjectId, int classId) override;
+
+    // Attendance operations
+    bool markAttendance(int studentId, int subjectId, int classId,
+                       const Date& date, const string& status) override;
+    // All checks happen inside a single INSERT ... SELECT; extra queries
+    // only run on failure to report which one failed
+    MarkAttendanceResult markAttendanceChecked(int studentId, int subjectId,
+                                               const Date& date, const string& status) override;
+    vector<MarkAttendanceResult> markAttendanceBulk(int subjectId, const Date& date,
+                                                    const vector<AttendanceMark>& marks,
+                                                    int classId) override;
+    // One transaction: one validation query, one duplicate check and one
+    // multi-row INSERT. Retried on deadlock or lock wait timeout; if it still
+    // fails, the valid marks are retried as one-entry batches instead.
+    vector<MarkAttendanceResult> markAttendanceBatch(const vector<AttendanceEntry>& entries) override;
+    vector<AttendanceRecord> getStudentAttendance(int studentId) override;
+    vector<AttendanceRecord> getRecentAttendance(int studentId, int limit) override;
+    vector<AttendanceRecord> getClassAttendance(int classId) override;
+
+    // Rows are read from the server one at a time (unbuffered), so the
+    // connection stays busy until the call returns
+    bool forEachStudentAttendance(int studentId, const AttendanceVisitor& visitor) override;
+    bool forEachClassAttendance(int classId, const AttendanceVisitor& visitor) override;
+    vector<AttendanceRecord> getClassAttendancePage(int classId, const AttendanceRecord& after,
+                                                    int limit) override;
+    double getAttendancePercentage(int studentId, int subjectId) override;
+    vector<AttendanceSummary> getAttendanceSummary(int studentId) override;
+    bool rebuildAttendanceSummary() override;
+    vector<SessionSheetEntry> getClassSessionSheet(int classId, int subjectId, const Date& date) override;
+
+    // Class-Subject operations
+    bool addSubjectToClass(int classId, int subjectId) override;
+    vector<Subject> getClassSubjects(int classId) override;
+    unordered_map<int, vector<Subject>> getAllClassSubjects() override;
+
+    // Schema maintenance (used by the migration runner in Migrations.h)
+    bool executeSql(const string& sql);
+    int getSchemaVersion();  // -1 on error; creates schema_migrations if missing
+    bool recordMigration(int version, const string& description);
+    vector<map<string, string>> explainQuery(const string& query);
+};
+
+#endif // MYSQLDATABASE_H
@@ -0,0 +1,67 @@
+#ifndef REFERENCECACHE_H
+#define REFERENCECACHE_H
+
+#include "ConnectionPool.h"
+#include "Models.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Immutable copy of the slow-changing reference tables. Never modified once
+// published, so any number of threads may read it without synchronisation.
+// Readers share ownership, so a replaced snapshot is freed once the last
+// request using it lets go.
+struct ReferenceSnapshot {
+    vector<Subject> subjects;
+    vector<ClassInfo> classes;
+    vector<Teacher> teachers;                            // with class teacher details
+    unordered_map<int, vector<Subject>> classSubjects;   // class id -> subjects
+    uint64_t generation = 0;                             // 1 for the first snapshot, then counting up
+
+    const Subject* findSubject(int id) const;
+    const ClassInfo* findClass(int id) const;
+    const vector<Subject>& subjectsForClass(int classId) const;
+
+private:
+    friend class ReferenceCache;
+    unordered_map<int, size_t> subjectIndex;
+    unordered_map<int, size_t> classIndex;
+};
+
+// In-process cache of subjects, classes, teachers and class subjects for the
+// API server. Reads are a single atomic load; writers call refresh() after
+// changing any of these tables, which rebuilds and swaps in a new snapshot.
+class ReferenceCache {
+public:
+    explicit ReferenceCache(ConnectionPool& pool);
+
+    ReferenceCache(const ReferenceCache&) = delete;
+    ReferenceCache& operator=(const ReferenceCache&) = delete;
+
+    // Current snapshot, loading it first if none has been built yet and
+    // retrying a failed refresh if no other thread is already doing so.
+    // Returns null only if the first load fails.
+    shared_ptr<const ReferenceSnapshot> snapshot();
+
+    // Rebuilds from the database and publishes the result. On any query
+    // error the current snapshot stays in place, marked stale so readers
+    // retry, and this returns false.
+    bool refresh();
+
+private:
+    ConnectionPool& pool;
+    shared_ptr<const ReferenceSnapshot> current;   // only through atomic_load/atomic_store
+    atomic<bool> stale{false};   // the last refresh failed after a write
+
+    // Serialises rebuilds so an older one can never overwrite a newer one
+    mutex refreshMutex;
+    uint64_t generations = 0;    // snapshots published so far (guarded by refreshMutex)
+
+    bool reload();   // refresh() with refreshMutex held
+};
+
+#endif // REFERENCECACHE_H
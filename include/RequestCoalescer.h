@@ -0,0 +1,39 @@
+#ifndef REQUESTCOALESCER_H
+#define REQUESTCOALESCER_H
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+// Single-flight execution for read requests. The first caller with a given
+// key runs the work; callers with the same key that arrive while it is
+// running wait for it and receive the same finished response instead of
+// repeating the database queries and serialization. Nothing is cached: once
+// a flight lands, the next caller starts a new one.
+class RequestCoalescer {
+public:
+    struct Response {
+        int status = -1;
+        string contentType;
+        string body;
+        bool failed = false;  // an error reply, which must not carry an ETag
+    };
+    using Result = shared_ptr<const Response>;
+
+    // `joined` is set when this caller shared another caller's flight.
+    // If the work throws, every caller waiting on it gets the exception.
+    Result run(const string& key, const function<Response()>& produce, bool& joined);
+
+    size_t inFlight() const;
+
+private:
+    mutable mutex lock;
+    unordered_map<string, shared_future<Result>> flights;
+};
+
+#endif // REQUESTCOALESCER_H
@@ -0,0 +1,55 @@
+#ifndef SESSIONTOKENS_H
+#define SESSIONTOKENS_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+using namespace std;
+
+enum class Role : uint8_t {
+    Admin,
+    Teacher,
+    Student
+};
+
+const char* toString(Role role);
+
+// Who a verified token belongs to. Admins have no id (0).
+struct Session {
+    Role role = Role::Student;
+    int id = 0;
+    int64_t expiresAt = 0;  // unix seconds
+};
+
+// Stateless API sessions: "<role>.<id>.<expiry>.<signature>", where the
+// signature is HMAC-SHA256 of the rest under a server secret (base64url).
+// Verification is a couple of SHA-256 blocks on the calling thread: no
+// database, no shared session table, no locks.
+class SessionTokens {
+public:
+    SessionTokens(const string& secret, chrono::seconds ttl);
+
+    string issue(Role role, int id) const;
+
+    // nullopt if the token is malformed, forged or expired
+    optional<Session> verify(const string& token) const;
+
+    chrono::seconds lifetime() const { return ttl; }
+
+private:
+    // SHA-256 state after absorbing the HMAC inner and outer key pads, so
+    // each signature only hashes the message itself
+    struct HashState {
+        uint32_t h[8];
+    };
+
+    HashState innerPad;
+    HashState outerPad;
+    chrono::seconds ttl;
+
+    string sign(const string& message) const;
+};
+
+#endif // SESSIONTOKENS_H
@@ -0,0 +1,41 @@
+#ifndef STATICASSETS_H
+#define STATICASSETS_H
+
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+struct StaticAsset {
+    string contentType;
+    string body;
+    string gzipped;     // empty unless compressing paid off
+    string etag;        // strong, from the content hash
+    string version;     // short hash; pages reference the asset as path?v=<version>
+};
+
+// The web frontend's files, read into memory at startup. Text files are
+// gzipped once here rather than per request, and every page's references to
+// the other files get a ?v=<content hash> query, so the browser can cache
+// those for a long time and still picks up a changed file on the next page
+// load. Files changed on disk after startup are not seen until a restart.
+class StaticAssets {
+public:
+    // Loads every regular file under root (up to maxFileBytes each) and
+    // returns how many were loaded
+    size_t load(const string& root, size_t maxFileBytes = size_t(4) << 20);
+
+    // By URL path; "/" and directories map to their index.html. nullptr if
+    // the path was not loaded.
+    const StaticAsset* find(const string& path) const;
+
+    size_t totalBytes() const;
+    size_t totalGzippedBytes() const;
+
+private:
+    unordered_map<string, StaticAsset> assets;   // "/css/style.css" -> asset
+
+    void versionReferences(StaticAsset& page) const;
+};
+
+#endif // STATICASSETS_H
@@ -0,0 +1,49 @@
+#ifndef TABLEVERSIONS_H
+#define TABLEVERSIONS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Table bitmasks for TableVersions
+struct Tables {
+    enum : unsigned {
+        Subjects        = 1 << 0,
+        Classes         = 1 << 1,
+        Teachers        = 1 << 2,
+        Students        = 1 << 3,
+        ClassSubjects   = 1 << 4,
+        TeacherSubjects = 1 << 5,
+        Attendance      = 1 << 6,
+        All             = (1 << 7) - 1
+    };
+};
+
+// Change counters for the tables behind the API's GET responses, used as
+// strong ETags. Every write through the API bumps the tables it touched; a
+// response built from a set of tables is unchanged for as long as their
+// counters are. Counters start over with each process, so tags also carry a
+// random per-process prefix.
+class TableVersions {
+public:
+    TableVersions();
+
+    void bump(unsigned tables);
+
+    // Quoted tag covering `tables`; `extra` folds in any other version the
+    // response depends on (e.g. a cache snapshot)
+    string etag(unsigned tables, uint64_t extra = 0) const;
+
+    // Tables a Database method writes, by name ("createStudent"); 0 for reads
+    static unsigned writtenBy(const string& method);
+
+private:
+    static constexpr int tableCount = 7;
+
+    atomic<uint64_t> versions[tableCount];
+    string prefix;
+};
+
+#endif // TABLEVERSIONS_H
@@ -0,0 +1,49 @@
+#ifndef TEACHERASSIGNMENTINDEX_H
+#define TEACHERASSIGNMENTINDEX_H
+
+#include "Database.h"
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+// Who may mark what: each teacher's (subject, class) pairs and each class's
+// class teacher (with the class name, for display), held in memory so authorizing an attendance write is a hash
+// lookup instead of a getTeacherSubjectAssignments query and scan. Loaded
+// once, then kept current by calling assign* after each successful write.
+class TeacherAssignmentIndex {
+public:
+    // Replaces the contents with the assignments stored in `db`
+    void load(Database& db);
+
+    void assignClassTeacher(const ClassInfo& cls, int teacherId);
+    void assignSubjectTeacher(int teacherId, const Assignment& assignment);
+
+    // The teacher is assigned this subject in this class
+    bool canMark(int teacherId, int subjectId, int classId) const;
+    // Class teacher of the class, or teaches any subject in it
+    bool teachesClass(int teacherId, int classId) const;
+    int classTeacherOf(int classId) const;  // 0 if none
+    // The class this teacher is class teacher of (lowest id if several)
+    optional<ClassInfo> classOf(int teacherId) const;
+    // The teacher's (subject, class) assignments with names, for listing
+    vector<Assignment> assignmentsOf(int teacherId) const;
+
+    size_t assignmentCount() const;
+
+private:
+    static uint64_t key(int subjectId, int classId) {
+        return (uint64_t(uint32_t(subjectId)) << 32) | uint32_t(classId);
+    }
+
+    mutable shared_mutex lock;
+    unordered_map<int, unordered_set<uint64_t>> subjectClasses;  // teacher -> (subject << 32 | class)
+    unordered_map<int, vector<Assignment>> teacherSubjects;      // the same pairs in load order
+    unordered_map<int, int> classTeachers;                       // class -> teacher
+    unordered_map<int, string> classNames;                       // class -> name, for the above
+};
+
+#endif // TEACHERASSIGNMENTINDEX_H
@@ -2,16 +2,19 @@
 #define TEACHERCONTROLLER_H
 
 #include "BaseController.h"
+#include "TeacherAssignmentIndex.h"
 #include <string>
 
 class TeacherController : public BaseController {
 private:
+    const TeacherAssignmentIndex& assignments;
     int teacherId;
     std::string teacherName;
     std::string teacherType;
     
 public:
-    TeacherController(Database* db, int id, const std::string& name, const std::string& type);
+    TeacherController(Database* db, const TeacherAssignmentIndex& assignments,
+                      int id, const std::string& name, const std::string& type);
     
     void markAttendance();
     void viewStudentAttendance();
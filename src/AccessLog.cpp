@@ -0,0 +1,201 @@
+#include "AccessLog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+const auto flushInterval = chrono::milliseconds(200);
+
+uint64_t nextRandom(uint64_t& state) {
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+void appendJsonString(string& out, const char* text) {
+    out += '"';
+    for (const char* p = text; *p; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += *p;
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += *p;
+        }
+    }
+    out += '"';
+}
+
+void appendTimestamp(string& out, int64_t timeMs) {
+    time_t seconds = static_cast<time_t>(timeMs / 1000);
+    tm utc;
+    gmtime_r(&seconds, &utc);
+    char text[32];
+    size_t length = strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &utc);
+    snprintf(text + length, sizeof(text) - length, ".%03dZ", static_cast<int>(timeMs % 1000));
+    out += '"';
+    out += text;
+    out += '"';
+}
+
+} // namespace
+
+AccessLog::AccessLog(const string& path, size_t maxFileBytes, int keepFiles, double sampleRate)
+    : path(path), maxFileBytes(maxFileBytes), keepFiles(max(keepFiles, 1)) {
+    sampleRate = min(max(sampleRate, 0.0), 1.0);
+    sampleAll = sampleRate >= 1.0;
+    sampleThreshold = static_cast<uint64_t>(sampleRate * 18446744073709551615.0);
+
+    out.open(path, ios::app | ios::binary);
+    if (!out.is_open()) {
+        cerr << "Access log: cannot open " << path << "; requests will not be logged" << endl;
+        return;
+    }
+    out.seekp(0, ios::end);
+    fileBytes = static_cast<size_t>(out.tellp());
+    enabled = true;
+    writer = thread(&AccessLog::run, this);
+}
+
+AccessLog::~AccessLog() {
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (writer.joinable()) writer.join();
+}
+
+AccessLog::Ring& AccessLog::localRing() {
+    // One ring per (thread, log); the API server only ever has one log
+    thread_local const AccessLog* owner = nullptr;
+    thread_local Ring* ring = nullptr;
+    if (owner != this) {
+        auto fresh = make_unique<Ring>();
+        fresh->random = hash<thread::id>()(this_thread::get_id()) | 1;
+        ring = fresh.get();
+        owner = this;
+        lock_guard<mutex> lock(ringsMutex);
+        rings.push_back(move(fresh));
+    }
+    return *ring;
+}
+
+void AccessLog::log(const string& method, const string& requestPath, int status,
+                    chrono::microseconds latency, chrono::microseconds dbTime, size_t bytes) {
+    if (!enabled.load(memory_order_relaxed)) return;
+
+    Ring& ring = localRing();
+    if (!sampleAll && status < 500 && nextRandom(ring.random) >= sampleThreshold) return;
+
+    uint64_t head = ring.head.load(memory_order_relaxed);
+    if (head - ring.tail.load(memory_order_acquire) == ringSize) {
+        ring.dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    Record& record = ring.slots[head & (ringSize - 1)];
+    record.timeMs = chrono::duration_cast<chrono::milliseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    record.latencyUs = static_cast<uint32_t>(min<int64_t>(latency.count(), UINT32_MAX));
+    record.dbUs = static_cast<uint32_t>(min<int64_t>(dbTime.count(), UINT32_MAX));
+    record.bytes = static_cast<uint32_t>(min<size_t>(bytes, UINT32_MAX));
+    record.status = static_cast<uint16_t>(status);
+    strncpy(record.method, method.c_str(), sizeof(record.method) - 1);
+    record.method[sizeof(record.method) - 1] = '\0';
+    strncpy(record.path, requestPath.c_str(), sizeof(record.path) - 1);
+    record.path[sizeof(record.path) - 1] = '\0';
+
+    ring.head.store(head + 1, memory_order_release);
+}
+
+void AccessLog::run() {
+    string buffer;
+    bool done = false;
+    while (!done) {
+        {
+            unique_lock<mutex> lock(wakeMutex);
+            wake.wait_for(lock, flushInterval, [this] { return stopping; });
+            done = stopping;
+        }
+
+        // A final pass after stop picks up whatever was logged before it
+        if (!drain(buffer)) continue;
+
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+        fileBytes += buffer.size();
+        buffer.clear();
+
+        if (maxFileBytes > 0 && fileBytes >= maxFileBytes) {
+            rotate();
+        }
+    }
+}
+
+bool AccessLog::drain(string& buffer) {
+    vector<Ring*> snapshot;
+    {
+        lock_guard<mutex> lock(ringsMutex);
+        for (const auto& ring : rings) snapshot.push_back(ring.get());
+    }
+
+    for (Ring* ring : snapshot) {
+        uint64_t tail = ring->tail.load(memory_order_relaxed);
+        uint64_t head = ring->head.load(memory_order_acquire);
+
+        for (; tail != head; ++tail) {
+            const Record& record = ring->slots[tail & (ringSize - 1)];
+            buffer += "{\"ts\":";
+            appendTimestamp(buffer, record.timeMs);
+            buffer += ",\"method\":";
+            appendJsonString(buffer, record.method);
+            buffer += ",\"path\":";
+            appendJsonString(buffer, record.path);
+            buffer += ",\"status\":" + to_string(record.status) +
+                      ",\"latency_us\":" + to_string(record.latencyUs) +
+                      ",\"db_us\":" + to_string(record.dbUs) +
+                      ",\"bytes\":" + to_string(record.bytes) + "}\n";
+        }
+        ring->tail.store(tail, memory_order_release);
+
+        uint64_t dropped = ring->dropped.exchange(0, memory_order_relaxed);
+        if (dropped > 0) {
+            int64_t nowMs = chrono::duration_cast<chrono::milliseconds>(
+                chrono::system_clock::now().time_since_epoch()).count();
+            buffer += "{\"ts\":";
+            appendTimestamp(buffer, nowMs);
+            buffer += ",\"dropped\":" + to_string(dropped) + "}\n";
+        }
+    }
+    return !buffer.empty();
+}
+
+void AccessLog::rotate() {
+    out.close();
+
+    // path.(n-1) -> path.n, ..., path -> path.1; the oldest is overwritten
+    for (int i = keepFiles - 1; i >= 1; --i) {
+        string from = i == 1 ? path : path + "." + to_string(i - 1);
+        rename(from.c_str(), (path + "." + to_string(i)).c_str());
+    }
+    if (keepFiles == 1) remove(path.c_str());
+
+    out.open(path, ios::trunc | ios::binary);
+    fileBytes = 0;
+    if (!out.is_open()) {
+        cerr << "Access log: cannot reopen " << path << " after rotation; logging stopped" << endl;
+        enabled = false;
+    }
+}
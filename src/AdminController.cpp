@@ -5,7 +5,8 @@
 
 using namespace std;
 
-AdminController::AdminController(Database* db) : BaseController(db) {}
+AdminController::AdminController(Database* db, TeacherAssignmentIndex& assignments)
+    : BaseController(db), assignments(assignments) {}
 
 void AdminController::createSubject() {
     UIHelper::clearScreen();
@@ -63,7 +64,7 @@ void AdminController::createTeacher() {
     string email = getInput("Enter email: ");
     string password = getInput("Enter password: ");
     double salary = getDoubleInput("Enter salary: ");
-    string joinDate = getDate("Enter join date:");
+    Date joinDate = getDate("Enter join date:");
     
     cout << "\nSelect teacher type:" << endl;
     cout << "1. ClassTeacher" << endl;
@@ -97,7 +98,7 @@ void AdminController::createStudent() {
     cout << "\nAvailable Classes:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& cls : classes) {
-        cout << "ID: " << cls.at("class_id") << " - " << cls.at("class_name") << endl;
+        cout << "ID: " << cls.id << " - " << cls.name << endl;
     }
     UIHelper::printSeparator(40);
     
@@ -136,7 +137,7 @@ void AdminController::assignClassTeacher() {
     cout << "\nAvailable Classes:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& cls : classes) {
-        cout << "ID: " << cls.at("class_id") << " - " << cls.at("class_name") << endl;
+        cout << "ID: " << cls.id << " - " << cls.name << endl;
     }
     
     // Show available teachers
@@ -150,8 +151,8 @@ void AdminController::assignClassTeacher() {
     cout << "\nAvailable Teachers:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& teacher : teachers) {
-        cout << "ID: " << teacher.at("teacher_id") << " - " << teacher.at("name") 
-                  << " (" << teacher.at("teacher_type") << ")" << endl;
+        cout << "ID: " << teacher.id << " - " << teacher.name 
+                  << " (" << teacher.type << ")" << endl;
     }
     UIHelper::printSeparator(40);
     
@@ -172,6 +173,12 @@ void AdminController::assignClassTeacher() {
     }
     
     if (db->assignClassTeacher(classId, teacherId)) {
+        ClassInfo assigned;
+        assigned.id = classId;
+        for (const auto& cls : classes) {
+            if (cls.id == classId) assigned.name = cls.name;
+        }
+        assignments.assignClassTeacher(assigned, teacherId);
         cout << "\nClass teacher assigned successfully!" << endl;
     } else {
         cout << "\nFailed to assign class teacher." << endl;
@@ -195,7 +202,7 @@ void AdminController::assignSubjectTeacher() {
     cout << "\nAvailable Teachers:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& teacher : teachers) {
-        cout << "ID: " << teacher.at("teacher_id") << " - " << teacher.at("name") << endl;
+        cout << "ID: " << teacher.id << " - " << teacher.name << endl;
     }
     
     // Show available subjects
@@ -209,7 +216,7 @@ void AdminController::assignSubjectTeacher() {
     cout << "\nAvailable Subjects:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& subject : subjects) {
-        cout << "ID: " << subject.at("subject_id") << " - " << subject.at("name") << endl;
+        cout << "ID: " << subject.id << " - " << subject.name << endl;
     }
     
     // Show available classes
@@ -223,7 +230,7 @@ void AdminController::assignSubjectTeacher() {
     cout << "\nAvailable Classes:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& cls : classes) {
-        cout << "ID: " << cls.at("class_id") << " - " << cls.at("class_name") << endl;
+        cout << "ID: " << cls.id << " - " << cls.name << endl;
     }
     UIHelper::printSeparator(40);
     
@@ -251,6 +258,16 @@ void AdminController::assignSubjectTeacher() {
     }
     
     if (db->assignSubjectTeacher(teacherId, subjectId, classId)) {
+        Assignment assignment;
+        assignment.subjectId = subjectId;
+        assignment.classId = classId;
+        for (const auto& subject : subjects) {
+            if (subject.id == subjectId) assignment.subjectName = subject.name;
+        }
+        for (const auto& cls : classes) {
+            if (cls.id == classId) assignment.className = cls.name;
+        }
+        assignments.assignSubjectTeacher(teacherId, assignment);
         cout << "\nSubject teacher assigned successfully!" << endl;
     } else {
         cout << "\nFailed to assign subject teacher. May already be assigned." << endl;
@@ -274,7 +291,7 @@ void AdminController::addSubjectToClass() {
     cout << "\nAvailable Classes:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& cls : classes) {
-        cout << "ID: " << cls.at("class_id") << " - " << cls.at("class_name") << endl;
+        cout << "ID: " << cls.id << " - " << cls.name << endl;
     }
     
     // Show available subjects
@@ -288,7 +305,7 @@ void AdminController::addSubjectToClass() {
     cout << "\nAvailable Subjects:" << endl;
     UIHelper::printSeparator(40);
     for (const auto& subject : subjects) {
-        cout << "ID: " << subject.at("subject_id") << " - " << subject.at("name") << endl;
+        cout << "ID: " << subject.id << " - " << subject.name << endl;
     }
     UIHelper::printSeparator(40);
     
@@ -339,9 +356,9 @@ void AdminController::viewAllSubjects() {
         UIHelper::printSeparator(55);
         
         for (const auto& subject : subjects) {
-            cout << left << setw(10) << subject.at("subject_id")
-                      << setw(30) << subject.at("name")
-                      << setw(15) << subject.at("max_marks") << endl;
+            cout << left << setw(10) << subject.id
+                      << setw(30) << subject.name
+                      << setw(15) << subject.maxMarks << endl;
         }
     }
     
@@ -362,8 +379,8 @@ void AdminController::viewAllClasses() {
         UIHelper::printSeparator(40);
         
         for (const auto& cls : classes) {
-            cout << left << setw(10) << cls.at("class_id")
-                      << setw(30) << cls.at("class_name") << endl;
+            cout << left << setw(10) << cls.id
+                      << setw(30) << cls.name << endl;
         }
     }
     
@@ -386,10 +403,10 @@ void AdminController::viewAllTeachers() {
         UIHelper::printSeparator(85);
         
         for (const auto& teacher : teachers) {
-            cout << left << setw(10) << teacher.at("teacher_id")
-                      << setw(25) << teacher.at("name")
-                      << setw(30) << teacher.at("email")
-                      << setw(20) << teacher.at("teacher_type") << endl;
+            cout << left << setw(10) << teacher.id
+                      << setw(25) << teacher.name
+                      << setw(30) << teacher.email
+                      << setw(20) << teacher.type << endl;
         }
     }
     
@@ -411,9 +428,9 @@ void AdminController::viewAllStudents() {
         UIHelper::printSeparator(60);
         
         for (const auto& student : students) {
-            cout << left << setw(10) << student.at("student_id")
-                      << setw(30) << student.at("name")
-                      << setw(20) << student.at("class_name") << endl;
+            cout << left << setw(10) << student.id
+                      << setw(30) << student.name
+                      << setw(20) << student.className << endl;
         }
     }
     
@@ -490,6 +507,7 @@ void AdminController::deleteSubject() {
     
     if (confirm == 1) {
         if (db->deleteSubject(subjectId)) {
+            assignments.load(*db);  // the delete cascaded to its assignments
             cout << "\nSubject deleted successfully!" << endl;
         } else {
             cout << "\nFailed to delete subject. It may be referenced by other records." << endl;
@@ -521,6 +539,7 @@ void AdminController::deleteClass() {
     
     if (confirm == 1) {
         if (db->deleteClass(classId)) {
+            assignments.load(*db);  // the delete cascaded to its assignments
             cout << "\nClass deleted successfully!" << endl;
         } else {
             cout << "\nFailed to delete class. It may be referenced by other records." << endl;
@@ -552,6 +571,7 @@ void AdminController::deleteTeacher() {
     
     if (confirm == 1) {
         if (db->deleteTeacher(teacherId)) {
+            assignments.load(*db);  // the delete cascaded to its assignments
             cout << "\nTeacher deleted successfully!" << endl;
         } else {
             cout << "\nFailed to delete teacher. It may be referenced by other records." << endl;
@@ -0,0 +1,376 @@
+#include "AttendanceBitmapIndex.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define ATTENDANCE_SIMD 1
+#endif
+
+using namespace std;
+
+namespace {
+
+uint64_t rowKey(int studentId, int subjectId) {
+    return (uint64_t(uint32_t(studentId)) << 32) | uint32_t(subjectId);
+}
+
+// popcount(a[i] & b[i]) summed over `words` words
+using PopcountAnd = uint64_t (*)(const uint64_t* a, const uint64_t* b, size_t words);
+
+uint64_t popcountAndScalar(const uint64_t* a, const uint64_t* b, size_t words) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < words; ++i) {
+        total += __builtin_popcountll(a[i] & b[i]);
+    }
+    return total;
+}
+
+#ifdef ATTENDANCE_SIMD
+// Nibble lookup popcount (pshufb), summed per 64-bit lane with psadbw
+
+__attribute__((target("avx2")))
+uint64_t popcountAndAvx2(const uint64_t* a, const uint64_t* b, size_t words) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 4 <= words; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        __m256i counts = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low)),
+            _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    uint64_t total = uint64_t(_mm256_extract_epi64(acc, 0)) + uint64_t(_mm256_extract_epi64(acc, 1)) +
+                     uint64_t(_mm256_extract_epi64(acc, 2)) + uint64_t(_mm256_extract_epi64(acc, 3));
+    return total + popcountAndScalar(a + i, b + i, words - i);
+}
+
+__attribute__((target("ssse3")))
+uint64_t popcountAndSsse3(const uint64_t* a, const uint64_t* b, size_t words) {
+    const __m128i lookup = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low = _mm_set1_epi8(0x0f);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 2 <= words; i += 2) {
+        __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        __m128i counts = _mm_add_epi8(
+            _mm_shuffle_epi8(lookup, _mm_and_si128(v, low)),
+            _mm_shuffle_epi8(lookup, _mm_and_si128(_mm_srli_epi16(v, 4), low)));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(counts, _mm_setzero_si128()));
+    }
+
+    uint64_t total = uint64_t(_mm_cvtsi128_si64(acc)) +
+                     uint64_t(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+    return total + popcountAndScalar(a + i, b + i, words - i);
+}
+#endif
+
+struct Kernel {
+    PopcountAnd popcountAnd;
+    const char* name;
+};
+
+Kernel selectKernel() {
+#ifdef ATTENDANCE_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {popcountAndAvx2, "avx2"};
+    if (__builtin_cpu_supports("ssse3")) return {popcountAndSsse3, "ssse3"};
+#endif
+    return {popcountAndScalar, "scalar"};
+}
+
+const Kernel kernel = selectKernel();
+
+} // namespace
+
+AttendanceBitmapIndex::AttendanceBitmapIndex(ConnectionPool& pool, const Date& termStart, const Date& termEnd)
+    : pool(pool), start(termStart), end(termEnd), firstDay(termStart.daysSinceEpoch()) {
+    days = max(termEnd.daysSinceEpoch() - firstDay + 1, 1);
+    words = ((days + 63) / 64 + 3) & ~size_t(3);
+}
+
+AttendanceBitmapIndex::~AttendanceBitmapIndex() {
+    {
+        lock_guard<mutex> guard(refreshMutex);
+        stopping = true;
+    }
+    refreshWake.notify_one();
+    if (refresher.joinable()) refresher.join();
+}
+
+void AttendanceBitmapIndex::scheduleRebuild() {
+    lock_guard<mutex> guard(refreshMutex);
+    rebuildRequested = true;
+    if (!refresher.joinable()) {
+        refresher = thread(&AttendanceBitmapIndex::refreshLoop, this);
+    }
+    refreshWake.notify_one();
+}
+
+void AttendanceBitmapIndex::refreshEvery(chrono::seconds interval) {
+    lock_guard<mutex> guard(refreshMutex);
+    refreshInterval = interval;
+    if (!refresher.joinable() && interval.count() > 0) {
+        refresher = thread(&AttendanceBitmapIndex::refreshLoop, this);
+    }
+    refreshWake.notify_one();
+}
+
+void AttendanceBitmapIndex::refreshLoop() {
+    unique_lock<mutex> guard(refreshMutex);
+    while (true) {
+        auto wanted = [this] { return rebuildRequested || stopping; };
+        if (refreshInterval.count() > 0) {
+            // Timing out means the periodic rebuild is due
+            refreshWake.wait_for(guard, refreshInterval, wanted);
+        } else {
+            refreshWake.wait(guard, wanted);
+        }
+        if (stopping) return;
+        rebuildRequested = false;
+
+        guard.unlock();
+        if (!rebuild()) {
+            cerr << "Attendance index: background rebuild failed; serving the previous index" << endl;
+        }
+        guard.lock();
+    }
+}
+
+const char* AttendanceBitmapIndex::kernelName() {
+    return kernel.name;
+}
+
+size_t AttendanceBitmapIndex::rowCount() const {
+    shared_lock<shared_mutex> read(lock);
+    return current.rows.size();
+}
+
+int AttendanceBitmapIndex::dayOfTerm(const Date& date) const {
+    if (!date.isValid()) return -1;
+    int day = date.daysSinceEpoch() - firstDay;
+    return day >= 0 && day < days ? day : -1;
+}
+
+vector<uint64_t> AttendanceBitmapIndex::rangeMask(const Date& from, const Date& to) const {
+    vector<uint64_t> mask(words, 0);
+    int first = from.isValid() ? max(from.daysSinceEpoch() - firstDay, 0) : 0;
+    int last = to.isValid() ? min(to.daysSinceEpoch() - firstDay, days - 1) : days - 1;
+
+    for (int day = first; day <= last; ) {
+        int bit = day % 64;
+        int span = min(64 - bit, last - day + 1);
+        uint64_t bits = span == 64 ? ~uint64_t(0) : ((uint64_t(1) << span) - 1);
+        mask[day / 64] |= bits << bit;
+        day += span;
+    }
+    return mask;
+}
+
+void AttendanceBitmapIndex::setMark(Bitmaps& maps, int studentId, int subjectId, int day, bool present) const {
+    uint32_t newRow = maps.freeRows.empty() ? static_cast<uint32_t>(maps.keys.size()) : maps.freeRows.back();
+    auto inserted = maps.rows.emplace(rowKey(studentId, subjectId), newRow);
+    if (inserted.second) {
+        if (maps.freeRows.empty()) {
+            maps.keys.push_back({studentId, subjectId});
+            maps.bits.resize(maps.bits.size() + 2 * words, 0);
+        } else {
+            maps.freeRows.pop_back();
+            maps.keys[newRow] = {studentId, subjectId};   // forget() already zeroed its bits
+        }
+    }
+
+    uint64_t* marked = &maps.bits[2 * words * inserted.first->second];
+    uint64_t* presentBits = marked + words;
+    uint64_t bit = uint64_t(1) << (day % 64);
+
+    marked[day / 64] |= bit;
+    if (present) {
+        presentBits[day / 64] |= bit;
+    } else {
+        presentBits[day / 64] &= ~bit;
+    }
+}
+
+void AttendanceBitmapIndex::forget(Bitmaps& maps, const function<bool(const pair<int, int>&)>& match) const {
+    for (auto it = maps.rows.begin(); it != maps.rows.end(); ) {
+        uint32_t row = it->second;
+        if (!match(maps.keys[row])) {
+            ++it;
+            continue;
+        }
+        // Cleared and handed to the next new (student, subject) pair
+        fill_n(maps.bits.begin() + 2 * words * row, 2 * words, 0);
+        maps.keys[row] = {0, 0};
+        maps.freeRows.push_back(row);
+        it = maps.rows.erase(it);
+    }
+}
+
+void AttendanceBitmapIndex::apply(const function<void(Bitmaps&)>& change) {
+    unique_lock<shared_mutex> write(lock);
+    change(current);
+    if (rebuilding) {
+        replay.push_back(change);
+    }
+}
+
+bool AttendanceBitmapIndex::rebuild() {
+    lock_guard<mutex> serial(rebuildMutex);
+    {
+        unique_lock<shared_mutex> write(lock);
+        rebuilding = true;
+        replay.clear();
+    }
+
+    Bitmaps fresh;
+    size_t outsideTerm = 0;
+    bool loaded = false;
+
+    auto lease = pool.acquire();
+    if (lease) {
+        loaded = true;
+        for (const auto& cls : lease->getAllClasses()) {
+            loaded = lease->forEachClassAttendance(cls.id, [&](const AttendanceRecord& record) {
+                int day = dayOfTerm(record.date);
+                if (day < 0) {
+                    outsideTerm++;
+                } else {
+                    setMark(fresh, record.studentId, record.subjectId, day,
+                            record.status == AttendanceStatus::Present);
+                }
+                return true;
+            }) && loaded;
+        }
+    } else {
+        cerr << "Attendance index rebuild failed: no database connection" << endl;
+    }
+    lease.release();
+
+    unique_lock<shared_mutex> write(lock);
+    rebuilding = false;
+    if (!loaded) {
+        replay.clear();
+        return false;
+    }
+
+    for (const auto& change : replay) {
+        change(fresh);
+    }
+    replay.clear();
+    current = move(fresh);
+
+    if (outsideTerm > 0) {
+        cerr << "Attendance index: " << outsideTerm << " records fall outside the term "
+             << start.toString() << " to " << end.toString() << endl;
+    }
+    return true;
+}
+
+void AttendanceBitmapIndex::record(int studentId, int subjectId, const Date& date, AttendanceStatus status) {
+    int day = dayOfTerm(date);
+    if (day < 0) return;
+
+    bool present = status == AttendanceStatus::Present;
+    apply([this, studentId, subjectId, day, present](Bitmaps& maps) {
+        setMark(maps, studentId, subjectId, day, present);
+    });
+}
+
+void AttendanceBitmapIndex::forgetStudent(int studentId) {
+    apply([this, studentId](Bitmaps& maps) {
+        forget(maps, [studentId](const pair<int, int>& key) { return key.first == studentId; });
+    });
+}
+
+void AttendanceBitmapIndex::forgetSubject(int subjectId) {
+    apply([this, subjectId](Bitmaps& maps) {
+        forget(maps, [subjectId](const pair<int, int>& key) { return key.second == subjectId; });
+    });
+}
+
+AttendanceBitmapIndex::Counts AttendanceBitmapIndex::studentSubject(int studentId, int subjectId,
+                                                                    const Date& from, const Date& to) const {
+    vector<uint64_t> mask = rangeMask(from, to);
+    Counts counts;
+
+    shared_lock<shared_mutex> read(lock);
+    auto it = current.rows.find(rowKey(studentId, subjectId));
+    if (it == current.rows.end()) return counts;
+
+    const uint64_t* marked = &current.bits[2 * words * it->second];
+    counts.total = static_cast<int>(kernel.popcountAnd(marked, mask.data(), words));
+    counts.present = static_cast<int>(kernel.popcountAnd(marked + words, mask.data(), words));
+    return counts;
+}
+
+vector<AttendanceBitmapIndex::StudentCounts> AttendanceBitmapIndex::schoolReport(const Date& from,
+                                                                                const Date& to) const {
+    vector<uint64_t> mask = rangeMask(from, to);
+    map<int, Counts> byStudent;
+
+    {
+        shared_lock<shared_mutex> read(lock);
+        for (size_t row = 0; row < current.keys.size(); ++row) {
+            int studentId = current.keys[row].first;
+            if (studentId == 0) continue;
+
+            const uint64_t* marked = &current.bits[2 * words * row];
+            int total = static_cast<int>(kernel.popcountAnd(marked, mask.data(), words));
+            if (total == 0) continue;
+
+            Counts& counts = byStudent[studentId];
+            counts.total += total;
+            counts.present += static_cast<int>(kernel.popcountAnd(marked + words, mask.data(), words));
+        }
+    }
+
+    vector<StudentCounts> report;
+    report.reserve(byStudent.size());
+    for (const auto& entry : byStudent) {
+        report.push_back({entry.first, entry.second});
+    }
+    return report;
+}
+
+AttendanceBitmapIndex::ClassReport AttendanceBitmapIndex::classReport(const vector<int>& studentIds, int subjectId,
+                                                                      const Date& from, const Date& to) const {
+    vector<uint64_t> mask = rangeMask(from, to);
+    vector<uint64_t> anyMark(words, 0);
+    vector<uint64_t> anyMissed(words, 0);   // marked but not Present
+    ClassReport report;
+
+    {
+        shared_lock<shared_mutex> read(lock);
+        for (int studentId : studentIds) {
+            auto it = current.rows.find(rowKey(studentId, subjectId));
+            if (it == current.rows.end()) continue;
+
+            const uint64_t* marked = &current.bits[2 * words * it->second];
+            const uint64_t* present = marked + words;
+            report.counts.total += static_cast<int>(kernel.popcountAnd(marked, mask.data(), words));
+            report.counts.present += static_cast<int>(kernel.popcountAnd(present, mask.data(), words));
+
+            for (size_t w = 0; w < words; ++w) {
+                anyMark[w] |= marked[w];
+                anyMissed[w] |= marked[w] & ~present[w];
+            }
+        }
+    }
+
+    report.sessions = static_cast<int>(kernel.popcountAnd(anyMark.data(), mask.data(), words));
+    for (size_t w = 0; w < words; ++w) {
+        anyMark[w] &= ~anyMissed[w];
+    }
+    report.perfectDays = static_cast<int>(kernel.popcountAnd(anyMark.data(), mask.data(), words));
+    return report;
+}
@@ -0,0 +1,135 @@
+#include "AttendanceWriteQueue.h"
+#include <iostream>
+
+using namespace std;
+
+AttendanceWriteQueue::AttendanceWriteQueue(ConnectionPool& pool, size_t maxBatch,
+                                           chrono::milliseconds maxDelay)
+    : pool(pool), maxBatch(max<size_t>(maxBatch, 1)), maxDelay(maxDelay),
+      head(&stub), tail(&stub), pending(0), stopping(false) {
+    writer = thread(&AttendanceWriteQueue::run, this);
+}
+
+AttendanceWriteQueue::~AttendanceWriteQueue() {
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+future<MarkAttendanceResult> AttendanceWriteQueue::submit(AttendanceEntry entry) {
+    Node* node = new Node;
+    node->entry = move(entry);
+    future<MarkAttendanceResult> result = node->result.get_future();
+
+    push(node);
+
+    // Wake the writer when work appears or a batch fills; otherwise it is
+    // already awake and collecting
+    size_t before = pending.fetch_add(1, memory_order_acq_rel);
+    if (before == 0 || before + 1 == maxBatch) {
+        lock_guard<mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+
+    return result;
+}
+
+void AttendanceWriteQueue::push(Node* node) {
+    node->next.store(nullptr, memory_order_relaxed);
+    Node* prev = head.exchange(node, memory_order_acq_rel);
+    prev->next.store(node, memory_order_release);
+}
+
+AttendanceWriteQueue::Node* AttendanceWriteQueue::pop() {
+    Node* first = tail;
+    Node* next = first->next.load(memory_order_acquire);
+
+    if (first == &stub) {
+        if (next == nullptr) return nullptr;
+        tail = next;
+        first = next;
+        next = next->next.load(memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+        tail = next;
+        return first;
+    }
+
+    // first is the last node; a producer may be between its exchange and
+    // linking next. Leave it for the next round in that case.
+    if (first != head.load(memory_order_acquire)) return nullptr;
+
+    push(&stub);
+    next = first->next.load(memory_order_acquire);
+    if (next != nullptr) {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
+
+void AttendanceWriteQueue::run() {
+    vector<Node*> batch;
+    batch.reserve(maxBatch);
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return pending.load(memory_order_acquire) > 0 || stopping; });
+            if (stopping && pending.load(memory_order_acquire) == 0) return;
+
+            // Group-commit window: let concurrent marks join this transaction
+            wake.wait_for(lock, maxDelay, [this] {
+                return pending.load(memory_order_acquire) >= maxBatch || stopping;
+            });
+        }
+
+        while (batch.size() < maxBatch) {
+            Node* node = pop();
+            if (node == nullptr) break;
+            batch.push_back(node);
+        }
+
+        if (batch.empty()) {
+            // Only a half-linked push is pending; it completes momentarily
+            this_thread::yield();
+            continue;
+        }
+
+        pending.fetch_sub(batch.size(), memory_order_acq_rel);
+        commit(batch);
+        batch.clear();
+    }
+}
+
+void AttendanceWriteQueue::commit(vector<Node*>& batch) {
+    vector<AttendanceEntry> entries;
+    entries.reserve(batch.size());
+    for (Node* node : batch) {
+        entries.push_back(node->entry);
+    }
+
+    vector<MarkAttendanceResult> results(batch.size(), MarkAttendanceResult::Failed);
+    // An exception must not escape the writer thread (std::terminate) or
+    // leave the callers' promises unset; the batch just fails
+    try {
+        auto lease = pool.acquire();
+        if (lease) {
+            results = lease->markAttendanceBatch(entries);
+        } else {
+            cerr << "Attendance writer: no database connection for a batch of " << batch.size() << endl;
+        }
+    } catch (const exception& e) {
+        cerr << "Attendance writer: batch of " << batch.size() << " failed: " << e.what() << endl;
+        results.assign(batch.size(), MarkAttendanceResult::Failed);
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch[i]->result.set_value(results[i]);
+        delete batch[i];
+    }
+}
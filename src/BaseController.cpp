@@ -1,8 +1,6 @@
 #include "BaseController.h"
 #include <iostream>
 #include <limits>
-#include <sstream>
-#include <iomanip>
 
 using namespace std;
 
@@ -48,16 +46,17 @@ double BaseController::getDoubleInput(const string& prompt) {
     }
 }
 
-string BaseController::getDate(const string& prompt) {
-    int day, month, year;
+Date BaseController::getDate(const string& prompt) {
     cout << prompt << endl;
-    day = getIntInput("Day (1-31): ");
-    month = getIntInput("Month (1-12): ");
-    year = getIntInput("Year (e.g., 2025): ");
-    
-    ostringstream oss;
-    oss << year << "-" << setfill('0') << setw(2) << month << "-" 
-        << setfill('0') << setw(2) << day;
-    
-    return oss.str();
+    while (true) {
+        int day = getIntInput("Day (1-31): ");
+        int month = getIntInput("Month (1-12): ");
+        int year = getIntInput("Year (e.g., 2025): ");
+        
+        Date date = Date::fromCivil(year, month, day);
+        if (date.isValid()) {
+            return date;
+        }
+        cout << "Invalid date. Please try again." << endl;
+    }
 }
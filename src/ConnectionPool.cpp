@@ -0,0 +1,121 @@
+#include "ConnectionPool.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept : pool(other.pool), conn(other.conn) {
+    other.pool = nullptr;
+    other.conn = nullptr;
+}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        conn = other.conn;
+        other.pool = nullptr;
+        other.conn = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease() {
+    release();
+}
+
+void ConnectionPool::Lease::release() {
+    if (pool != nullptr && conn != nullptr) {
+        pool->giveBack(conn);
+    }
+    pool = nullptr;
+    conn = nullptr;
+}
+
+ConnectionPool::ConnectionPool(const map<string, string>& config)
+    : connectionConfig(config), pendingConnects(0) {
+    minConnections = config.count("pool_min_size") ? stoul(config.at("pool_min_size")) : 2;
+    maxConnections = config.count("pool_max_size") ? stoul(config.at("pool_max_size")) : 8;
+    int timeoutMs = config.count("pool_timeout_ms") ? stoi(config.at("pool_timeout_ms")) : 2000;
+
+    maxConnections = max<size_t>(maxConnections, 1);
+    minConnections = min(minConnections, maxConnections);
+    acquireTimeout = chrono::milliseconds(max(timeoutMs, 0));
+
+    // Open the minimum set up front (on the main thread, so libmysqlclient's
+    // one-time library initialisation happens before any worker starts)
+    for (size_t i = 0; i < minConnections; ++i) {
+        auto conn = Database::create(connectionConfig);
+        if (!conn->isConnected()) {
+            cerr << "Connection pool: failed to open connection " << (i + 1)
+                 << " of " << minConnections << endl;
+            break;
+        }
+        idle.push_back(conn.get());
+        connections.push_back(move(conn));
+    }
+}
+
+ConnectionPool::~ConnectionPool() {
+    lock_guard<mutex> lock(poolMutex);
+    idle.clear();
+    connections.clear();
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    auto deadline = chrono::steady_clock::now() + acquireTimeout;
+    unique_lock<mutex> lock(poolMutex);
+
+    while (true) {
+        if (!idle.empty()) {
+            Database* conn = idle.back();
+            idle.pop_back();
+            return Lease(this, conn);
+        }
+
+        // Grow lazily up to the maximum; connect outside the lock
+        if (connections.size() + pendingConnects < maxConnections) {
+            ++pendingConnects;
+            lock.unlock();
+            auto conn = Database::create(connectionConfig);
+            lock.lock();
+            --pendingConnects;
+
+            if (conn->isConnected()) {
+                Database* raw = conn.get();
+                connections.push_back(move(conn));
+                return Lease(this, raw);
+            }
+            cerr << "Connection pool: failed to open additional connection" << endl;
+            // Let other waiters retry the freed slot
+            connectionReturned.notify_one();
+        }
+
+        if (connectionReturned.wait_until(lock, deadline) == cv_status::timeout && idle.empty()) {
+            return Lease();
+        }
+    }
+}
+
+void ConnectionPool::giveBack(Database* conn) {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        idle.push_back(conn);
+    }
+    connectionReturned.notify_one();
+}
+
+size_t ConnectionPool::size() const {
+    lock_guard<mutex> lock(poolMutex);
+    return connections.size();
+}
+
+size_t ConnectionPool::idleCount() const {
+    lock_guard<mutex> lock(poolMutex);
+    return idle.size();
+}
+
+bool ConnectionPool::isConnected() const {
+    lock_guard<mutex> lock(poolMutex);
+    return !connections.empty();
+}
@@ -0,0 +1,124 @@
+#include "HttpCompression.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+using namespace std;
+
+namespace {
+
+string trim(const string& text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == string::npos) return "";
+    size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+// Calls visit(item) for each comma-separated, trimmed, non-empty item
+template <typename Visit>
+void forEachListItem(const string& list, Visit visit) {
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == string::npos) end = list.size();
+        string item = trim(list.substr(pos, end - pos));
+        if (!item.empty()) visit(item);
+        pos = end + 1;
+    }
+}
+
+const char* const codingSuffixes[] = {"+gzip\"", "+deflate\""};
+
+} // namespace
+
+const char* toString(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::Gzip: return "gzip";
+        case ContentEncoding::Deflate: return "deflate";
+        default: return "identity";
+    }
+}
+
+ContentEncoding negotiateEncoding(const string& acceptEncoding) {
+    // -1: not mentioned, so the "*" entry (if any) decides
+    double gzip = -1, deflate = -1, any = -1;
+
+    forEachListItem(acceptEncoding, [&](const string& item) {
+        string coding = trim(item.substr(0, item.find(';')));
+        transform(coding.begin(), coding.end(), coding.begin(), ::tolower);
+
+        double q = 1.0;
+        size_t qPos = item.find("q=");
+        if (qPos != string::npos) q = atof(item.c_str() + qPos + 2);
+
+        if (coding == "gzip" || coding == "x-gzip") gzip = q;
+        else if (coding == "deflate") deflate = q;
+        else if (coding == "*") any = q;
+    });
+
+    if (gzip < 0) gzip = max(any, 0.0);
+    if (deflate < 0) deflate = max(any, 0.0);
+
+    if (gzip > 0 && gzip >= deflate) return ContentEncoding::Gzip;
+    if (deflate > 0) return ContentEncoding::Deflate;
+    return ContentEncoding::Identity;
+}
+
+bool isCompressibleType(const string& contentType) {
+    string type = trim(contentType.substr(0, contentType.find(';')));
+    return type.compare(0, 5, "text/") == 0 ||
+           type == "application/json" ||
+           type == "application/javascript" ||
+           type == "application/xml" ||
+           type == "image/svg+xml";
+}
+
+bool compressBody(const char* data, size_t size, ContentEncoding encoding, int level, string& out) {
+    if (encoding == ContentEncoding::Identity) return false;
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // windowBits 15 is a zlib stream; +16 wraps it as gzip instead
+    int windowBits = encoding == ContentEncoding::Gzip ? 15 + 16 : 15;
+    if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    out.resize(deflateBound(&stream, size));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    // deflateBound guarantees one call is enough
+    int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+
+string encodedEtag(const string& etag, ContentEncoding encoding) {
+    if (encoding == ContentEncoding::Identity || etag.size() < 2 || etag.back() != '"') return etag;
+    return etag.substr(0, etag.size() - 1) + "+" + toString(encoding) + "\"";
+}
+
+bool etagMatches(const string& ifNoneMatch, const string& etag) {
+    bool found = false;
+    forEachListItem(ifNoneMatch, [&](const string& item) {
+        string candidate = item;
+        if (candidate.compare(0, 2, "W/") == 0) candidate.erase(0, 2);
+
+        // Back to the identity tag: "abc+gzip" -> "abc"
+        for (const char* suffix : codingSuffixes) {
+            size_t length = strlen(suffix);
+            if (candidate.size() > length &&
+                candidate.compare(candidate.size() - length, length, suffix) == 0) {
+                candidate.replace(candidate.size() - length, length, "\"");
+                break;
+            }
+        }
+        if (candidate == "*" || candidate == etag) found = true;
+    });
+    return found;
+}
@@ -0,0 +1,140 @@
+#include "JsonWriter.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+// Bytes that cannot appear unescaped in a JSON string
+struct EscapeTable {
+    bool escape[256] = {};
+    constexpr EscapeTable() {
+        for (int c = 0; c < 0x20; ++c) escape[c] = true;
+        escape[static_cast<unsigned char>('"')] = true;
+        escape[static_cast<unsigned char>('\\')] = true;
+    }
+};
+constexpr EscapeTable escapeTable;
+
+const char hexDigits[] = "0123456789abcdef";
+
+} // namespace
+
+void JsonWriter::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (depth == 0) return;
+    uint64_t bit = uint64_t(1) << (depth - 1);
+    if (hasItems & bit) out += ',';
+    hasItems |= bit;
+}
+
+void JsonWriter::open(char bracket) {
+    separate();
+    out += bracket;
+    ++depth;
+    hasItems &= ~(uint64_t(1) << (depth - 1));
+}
+
+void JsonWriter::close(char bracket) {
+    out += bracket;
+    --depth;
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    close(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* name) {
+    separate();
+    appendString(name, strlen(name));
+    out += ':';
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* text) {
+    return value(text, strlen(text));
+}
+
+JsonWriter& JsonWriter::value(const char* text, size_t length) {
+    separate();
+    appendString(text, length);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(int64_t number) {
+    separate();
+    char digits[24];
+    auto result = to_chars(digits, digits + sizeof(digits), number);
+    out.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    if (!isfinite(number)) return null();
+    separate();
+    // Shortest text that reads back as the same double
+    char digits[32];
+    auto result = to_chars(digits, digits + sizeof(digits), number);
+    out.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out += flag ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out += "null";
+    return *this;
+}
+
+void JsonWriter::appendString(const char* text, size_t length) {
+    out += '"';
+    // Copy runs of plain bytes in one go; most strings are a single run
+    size_t runStart = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (!escapeTable.escape[c]) continue;
+
+        out.append(text + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                char escaped[6] = {'\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xf]};
+                out.append(escaped, sizeof(escaped));
+            }
+        }
+    }
+    out.append(text + runStart, length - runStart);
+    out += '"';
+}
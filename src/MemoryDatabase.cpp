@@ -0,0 +1,822 @@
+#include "MemoryDatabase.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+
+namespace {
+
+using ReadLock = shared_lock<shared_mutex>;
+using WriteLock = unique_lock<shared_mutex>;
+
+// Equality under MySQL's default case-insensitive collation
+bool sameText(const string& a, const string& b) {
+    return a.size() == b.size() &&
+           equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return tolower(x) == tolower(y);
+           });
+}
+
+bool isPresent(const string& status) {
+    return parseAttendanceStatus(status) == AttendanceStatus::Present;
+}
+
+void duplicateEntry(const string& key) {
+    cerr << "Insert failed: Duplicate entry for key '" << key << "'" << endl;
+}
+
+void foreignKeyFails(const string& table) {
+    cerr << "Insert failed: foreign key constraint fails (" << table << ")" << endl;
+}
+
+} // namespace
+
+MemoryDatabase::MemoryDatabase() : store(createStore()) {}
+
+MemoryDatabase::MemoryDatabase(shared_ptr<Store> store) : store(move(store)) {}
+
+shared_ptr<MemoryDatabase::Store> MemoryDatabase::createStore() {
+    auto store = make_shared<Store>();
+    // Same seed row as database.sql
+    store->admins[store->nextAdminId++] = {"admin@school.com", "admin123"};
+    return store;
+}
+
+// Authentication
+bool MemoryDatabase::authenticateAdmin(const string& email, const string& password) {
+    ReadLock read(store->lock);
+    for (const auto& entry : store->admins) {
+        if (sameText(entry.second.email, email) && sameText(entry.second.password, password)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+optional<Teacher> MemoryDatabase::authenticateTeacher(const string& email, const string& password) {
+    ReadLock read(store->lock);
+    for (const auto& entry : store->teachers) {
+        const auto& row = entry.second;
+        if (sameText(row.teacher.email, email) && sameText(row.password, password)) {
+            Teacher teacher;
+            teacher.id = row.teacher.id;
+            teacher.name = row.teacher.name;
+            teacher.email = email; // Pass back the email used for login
+            teacher.type = row.teacher.type;
+            return teacher;
+        }
+    }
+    return nullopt;
+}
+
+// CRUD - Subjects
+int MemoryDatabase::createSubject(const string& name, int maxMarks) {
+    WriteLock write(store->lock);
+    for (const auto& entry : store->subjects) {
+        if (sameText(entry.second.name, name)) {
+            duplicateEntry("subjects.name");
+            return -1;
+        }
+    }
+
+    int id = store->nextSubjectId++;
+    store->subjects[id] = {id, name, maxMarks};
+    return id;
+}
+
+vector<Subject> MemoryDatabase::getAllSubjects() {
+    ReadLock read(store->lock);
+    vector<Subject> subjects;
+    subjects.reserve(store->subjects.size());
+    for (const auto& entry : store->subjects) {
+        subjects.push_back(entry.second);
+    }
+    return subjects;
+}
+
+optional<Subject> MemoryDatabase::getSubjectById(int id) {
+    ReadLock read(store->lock);
+    auto it = store->subjects.find(id);
+    if (it == store->subjects.end()) return nullopt;
+    return it->second;
+}
+
+// CRUD - Classes
+int MemoryDatabase::createClass(const string& className) {
+    WriteLock write(store->lock);
+    for (const auto& entry : store->classes) {
+        if (sameText(entry.second.name, className)) {
+            duplicateEntry("classes.class_name");
+            return -1;
+        }
+    }
+
+    int id = store->nextClassId++;
+    store->classes[id] = {id, className};
+    return id;
+}
+
+vector<ClassInfo> MemoryDatabase::getAllClasses() {
+    ReadLock read(store->lock);
+    vector<ClassInfo> classes;
+    classes.reserve(store->classes.size());
+    for (const auto& entry : store->classes) {
+        classes.push_back(entry.second);
+    }
+    return classes;
+}
+
+optional<ClassInfo> MemoryDatabase::getClassById(int id) {
+    ReadLock read(store->lock);
+    auto it = store->classes.find(id);
+    if (it == store->classes.end()) return nullopt;
+    return it->second;
+}
+
+// CRUD - Teachers
+int MemoryDatabase::createTeacher(const string& name, const string& email,
+                                 const string& password, double salary,
+                                 const Date& joinDate, const string& type) {
+    if (!joinDate.isValid()) {
+        cerr << "Insert failed: Incorrect date value for join_date" << endl;
+        return -1;
+    }
+
+    WriteLock write(store->lock);
+    for (const auto& entry : store->teachers) {
+        if (sameText(entry.second.teacher.email, email)) {
+            duplicateEntry("teachers.email");
+            return -1;
+        }
+    }
+
+    int id = store->nextTeacherId++;
+    auto& row = store->teachers[id];
+    row.teacher.id = id;
+    row.teacher.name = name;
+    row.teacher.email = email;
+    row.teacher.salary = round(salary * 100.0) / 100.0;  // DECIMAL(10,2)
+    row.teacher.joinDate = joinDate;
+    row.teacher.type = type;
+    row.password = password;
+    return id;
+}
+
+vector<Teacher> MemoryDatabase::getAllTeachers() {
+    ReadLock read(store->lock);
+    vector<Teacher> teachers;
+    teachers.reserve(store->teachers.size());
+    for (const auto& entry : store->teachers) {
+        teachers.push_back(entry.second.teacher);
+    }
+    return teachers;
+}
+
+vector<Teacher> MemoryDatabase::getAllTeachersWithDetails() {
+    ReadLock read(store->lock);
+    vector<Teacher> teachers;
+    teachers.reserve(store->teachers.size());
+
+    // LEFT JOIN semantics: one row per class taught, or one row without a class
+    for (const auto& entry : store->teachers) {
+        bool assigned = false;
+        for (const auto& assignment : store->classTeachers) {
+            if (assignment.second != entry.first) continue;
+            Teacher teacher = entry.second.teacher;
+            teacher.classId = assignment.first;
+            teacher.className = store->classes.at(assignment.first).name;
+            teachers.push_back(move(teacher));
+            assigned = true;
+        }
+        if (!assigned) {
+            teachers.push_back(entry.second.teacher);
+        }
+    }
+    return teachers;
+}
+
+optional<Teacher> MemoryDatabase::getTeacherById(int id) {
+    ReadLock read(store->lock);
+    auto it = store->teachers.find(id);
+    if (it == store->teachers.end()) return nullopt;
+    return it->second.teacher;
+}
+
+optional<ClassInfo> MemoryDatabase::getTeacherClassAssignment(int teacherId) {
+    ReadLock read(store->lock);
+    for (const auto& assignment : store->classTeachers) {
+        if (assignment.second == teacherId) {
+            return store->classes.at(assignment.first);
+        }
+    }
+    return nullopt;
+}
+
+vector<Assignment> MemoryDatabase::getTeacherSubjectAssignments(int teacherId) {
+    ReadLock read(store->lock);
+    vector<Assignment> assignments;
+
+    auto it = store->subjectTeachers.lower_bound({teacherId, 0, 0});
+    for (; it != store->subjectTeachers.end() && get<0>(*it) == teacherId; ++it) {
+        Assignment assignment;
+        assignment.subjectId = get<1>(*it);
+        assignment.subjectName = store->subjects.at(assignment.subjectId).name;
+        assignment.classId = get<2>(*it);
+        assignment.className = store->classes.at(assignment.classId).name;
+        assignments.push_back(move(assignment));
+    }
+    return assignments;
+}
+
+unordered_map<int, vector<Assignment>> MemoryDatabase::getAllTeacherSubjectAssignments() {
+    ReadLock read(store->lock);
+    unordered_map<int, vector<Assignment>> assignments;
+    for (const auto& row : store->subjectTeachers) {
+        Assignment assignment;
+        assignment.subjectId = get<1>(row);
+        assignment.subjectName = store->subjects.at(assignment.subjectId).name;
+        assignment.classId = get<2>(row);
+        assignment.className = store->classes.at(assignment.classId).name;
+        assignments[get<0>(row)].push_back(move(assignment));
+    }
+    return assignments;
+}
+
+bool MemoryDatabase::assignClassTeacher(int classId, int teacherId) {
+    WriteLock write(store->lock);
+    if (!store->classes.count(classId) || !store->teachers.count(teacherId)) {
+        foreignKeyFails("teacher_class_assignments");
+        return false;
+    }
+
+    // class_id is UNIQUE: replaces any existing class teacher
+    store->classTeachers[classId] = teacherId;
+    return true;
+}
+
+bool MemoryDatabase::assignSubjectTeacher(int teacherId, int subjectId, int classId) {
+    WriteLock write(store->lock);
+    if (!store->teachers.count(teacherId) || !store->subjects.count(subjectId) ||
+        !store->classes.count(classId)) {
+        foreignKeyFails("teacher_subject_assignments");
+        return false;
+    }
+
+    if (!store->subjectTeachers.insert({teacherId, subjectId, classId}).second) {
+        duplicateEntry("unique_assignment");
+        return false;
+    }
+    return true;
+}
+
+// CRUD - Students
+int MemoryDatabase::createStudent(const string& name, int classId) {
+    WriteLock write(store->lock);
+    if (classId > 0 && !store->classes.count(classId)) {
+        foreignKeyFails("students");
+        return -1;
+    }
+
+    int id = store->nextStudentId++;
+    store->students[id] = {name, classId > 0 ? classId : 0};
+    return id;
+}
+
+vector<Student> MemoryDatabase::getAllStudents() {
+    ReadLock read(store->lock);
+    vector<Student> students;
+    students.reserve(store->students.size());
+    for (const auto& entry : store->students) {
+        Student student;
+        student.id = entry.first;
+        student.name = entry.second.name;
+        student.classId = entry.second.classId;
+        student.className = student.classId > 0 ? store->classes.at(student.classId).name : "N/A";
+        students.push_back(move(student));
+    }
+    return students;
+}
+
+vector<Student> MemoryDatabase::getStudentsPage(int afterId, int limit) {
+    ReadLock read(store->lock);
+    vector<Student> students;
+
+    for (auto it = store->students.upper_bound(afterId);
+         it != store->students.end() && static_cast<int>(students.size()) < limit; ++it) {
+        Student student;
+        student.id = it->first;
+        student.name = it->second.name;
+        student.classId = it->second.classId;
+        if (student.classId > 0) {
+            student.className = store->classes.at(student.classId).name;
+        }
+        students.push_back(move(student));
+    }
+    return students;
+}
+
+int MemoryDatabase::countStudents() {
+    ReadLock read(store->lock);
+    return static_cast<int>(store->students.size());
+}
+
+optional<Student> MemoryDatabase::getStudentById(int id) {
+    ReadLock read(store->lock);
+    auto it = store->students.find(id);
+    if (it == store->students.end()) return nullopt;
+
+    Student student;
+    student.id = id;
+    student.name = it->second.name;
+    student.classId = it->second.classId;
+    student.className = student.classId > 0 ? store->classes.at(student.classId).name : "N/A";
+    return student;
+}
+
+vector<Student> MemoryDatabase::getStudentsByClass(int classId) {
+    ReadLock read(store->lock);
+    vector<Student> students;
+    for (const auto& entry : store->students) {
+        if (entry.second.classId != classId || classId == 0) continue;
+        Student student;
+        student.id = entry.first;
+        student.name = entry.second.name;
+        student.classId = classId;
+        students.push_back(move(student));
+    }
+    return students;
+}
+
+bool MemoryDatabase::updateStudentName(int studentId, const string& newName) {
+    WriteLock write(store->lock);
+    auto it = store->students.find(studentId);
+    if (it != store->students.end()) {
+        it->second.name = newName;
+    }
+    return true;
+}
+
+// Delete operations. Deleting a missing row succeeds, as DELETE does.
+bool MemoryDatabase::deleteSubject(int subjectId) {
+    WriteLock write(store->lock);
+    if (!store->subjects.erase(subjectId)) return true;
+
+    // ON DELETE CASCADE: class_subjects, teacher_subject_assignments,
+    // attendance_records and attendance_summary
+    for (auto it = store->classSubjects.begin(); it != store->classSubjects.end();) {
+        it = it->second == subjectId ? store->classSubjects.erase(it) : next(it);
+    }
+    for (auto it = store->subjectTeachers.begin(); it != store->subjectTeachers.end();) {
+        it = get<1>(*it) == subjectId ? store->subjectTeachers.erase(it) : next(it);
+    }
+    for (auto it = store->attendance.begin(); it != store->attendance.end();) {
+        it = get<1>(it->first) == subjectId ? store->attendance.erase(it) : next(it);
+    }
+    for (auto it = store->summary.begin(); it != store->summary.end();) {
+        it = it->first.second == subjectId ? store->summary.erase(it) : next(it);
+    }
+    return true;
+}
+
+bool MemoryDatabase::deleteClass(int classId) {
+    WriteLock write(store->lock);
+    if (!store->classes.erase(classId)) return true;
+
+    // students.class_id is ON DELETE SET NULL
+    for (auto& entry : store->students) {
+        if (entry.second.classId == classId) entry.second.classId = 0;
+    }
+
+    store->classTeachers.erase(classId);
+    for (auto it = store->subjectTeachers.begin(); it != store->subjectTeachers.end();) {
+        it = get<2>(*it) == classId ? store->subjectTeachers.erase(it) : next(it);
+    }
+    for (auto it = store->classSubjects.begin(); it != store->classSubjects.end();) {
+        it = it->first == classId ? store->classSubjects.erase(it) : next(it);
+    }
+
+    // The class's records cascade away while its students remain, so take
+    // them off the summary counters as MySqlDatabase::deleteClass does
+    for (auto it = store->attendance.begin(); it != store->attendance.end();) {
+        if (it->second.classId != classId) {
+            ++it;
+            continue;
+        }
+        auto& counters = store->summary[{get<0>(it->first), get<1>(it->first)}];
+        counters.total -= 1;
+        counters.present -= isPresent(it->second.status) ? 1 : 0;
+        it = store->attendance.erase(it);
+    }
+    return true;
+}
+
+bool MemoryDatabase::deleteTeacher(int teacherId) {
+    WriteLock write(store->lock);
+    if (!store->teachers.erase(teacherId)) return true;
+
+    for (auto it = store->classTeachers.begin(); it != store->classTeachers.end();) {
+        it = it->second == teacherId ? store->classTeachers.erase(it) : next(it);
+    }
+    for (auto it = store->subjectTeachers.begin(); it != store->subjectTeachers.end();) {
+        it = get<0>(*it) == teacherId ? store->subjectTeachers.erase(it) : next(it);
+    }
+    return true;
+}
+
+bool MemoryDatabase::deleteStudent(int studentId) {
+    WriteLock write(store->lock);
+    if (!store->students.erase(studentId)) return true;
+
+    store->attendance.erase(store->attendance.lower_bound({studentId, 0, 0}),
+                            store->attendance.lower_bound({studentId + 1, 0, 0}));
+    store->summary.erase(store->summary.lower_bound({studentId, 0}),
+                         store->summary.lower_bound({studentId + 1, 0}));
+    return true;
+}
+
+// Validation operations
+bool MemoryDatabase::classExists(int classId) {
+    ReadLock read(store->lock);
+    return store->classes.count(classId) > 0;
+}
+
+bool MemoryDatabase::subjectExists(int subjectId) {
+    ReadLock read(store->lock);
+    return store->subjects.count(subjectId) > 0;
+}
+
+bool MemoryDatabase::teacherExists(int teacherId) {
+    ReadLock read(store->lock);
+    return store->teachers.count(teacherId) > 0;
+}
+
+bool MemoryDatabase::studentExists(int studentId) {
+    ReadLock read(store->lock);
+    return store->students.count(studentId) > 0;
+}
+
+bool MemoryDatabase::isClassNameUnique(const string& className) {
+    ReadLock read(store->lock);
+    for (const auto& entry : store->classes) {
+        if (sameText(entry.second.name, className)) return false;
+    }
+    return true;
+}
+
+bool MemoryDatabase::isSubjectNameUnique(const string& subjectName) {
+    ReadLock read(store->lock);
+    for (const auto& entry : store->subjects) {
+        if (sameText(entry.second.name, subjectName)) return false;
+    }
+    return true;
+}
+
+bool MemoryDatabase::isAttendanceMarked(int studentId, int subjectId, const Date& date) {
+    if (!date.isValid()) return false;
+
+    ReadLock read(store->lock);
+    return store->attendance.count({studentId, subjectId, date.daysSinceEpoch()}) > 0;
+}
+
+bool MemoryDatabase::isSubjectInClass(int subjectId, int classId) {
+    ReadLock read(store->lock);
+    return store->classSubjects.count({classId, subjectId}) > 0;
+}
+
+// Attendance operations
+bool MemoryDatabase::markAttendance(int studentId, int subjectId, int classId,
+                                   const Date& date, const string& status) {
+    if (!date.isValid()) {
+        cerr << "Insert failed: Incorrect date value for attendance_date" << endl;
+        return false;
+    }
+
+    WriteLock write(store->lock);
+    if (!store->students.count(studentId) || !store->subjects.count(subjectId) ||
+        !store->classes.count(classId)) {
+        foreignKeyFails("attendance_records");
+        return false;
+    }
+
+    auto inserted = store->attendance.insert({{studentId, subjectId, date.daysSinceEpoch()},
+                                              {store->nextAttendanceId, classId, status}});
+    if (!inserted.second) {
+        duplicateEntry("unique_attendance");
+        return false;
+    }
+    store->nextAttendanceId++;
+
+    auto& counters = store->summary[{studentId, subjectId}];
+    counters.total += 1;
+    counters.present += isPresent(status) ? 1 : 0;
+    return true;
+}
+
+MarkAttendanceResult MemoryDatabase::markAttendanceChecked(int studentId, int subjectId,
+                                                          const Date& date, const string& status) {
+    return markAttendanceBatch({{studentId, subjectId, date, status}}).front();
+}
+
+vector<MarkAttendanceResult> MemoryDatabase::markAttendanceBulk(int subjectId, const Date& date,
+                                                               const vector<AttendanceMark>& marks,
+                                                               int classId) {
+    vector<AttendanceEntry> entries;
+    entries.reserve(marks.size());
+    for (const auto& mark : marks) {
+        entries.push_back({mark.studentId, subjectId, date, mark.status, classId});
+    }
+    return markAttendanceBatch(entries);
+}
+
+vector<MarkAttendanceResult> MemoryDatabase::markAttendanceBatch(const vector<AttendanceEntry>& entries) {
+    vector<MarkAttendanceResult> results(entries.size(), MarkAttendanceResult::Failed);
+    vector<pair<tuple<int, int, int32_t>, Store::AttendanceRow>> rows;
+    set<tuple<int, int, int32_t>> batchKeys;
+
+    WriteLock write(store->lock);
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i];
+        auto student = store->students.find(entry.studentId);
+
+        if (!entry.date.isValid()) {
+            continue;  // stays Failed
+        }
+        if (student == store->students.end()) {
+            results[i] = MarkAttendanceResult::StudentNotFound;
+            continue;
+        }
+        int classId = student->second.classId;
+        if (classId == 0) {
+            results[i] = MarkAttendanceResult::StudentHasNoClass;
+            continue;
+        }
+        if (entry.classId != 0 && classId != entry.classId) {
+            results[i] = MarkAttendanceResult::StudentNotInClass;
+            continue;
+        }
+        if (!store->classSubjects.count({classId, entry.subjectId})) {
+            results[i] = MarkAttendanceResult::SubjectNotInClass;
+            continue;
+        }
+
+        tuple<int, int, int32_t> key{entry.studentId, entry.subjectId, entry.date.daysSinceEpoch()};
+        if (store->attendance.count(key) || !batchKeys.insert(key).second) {
+            results[i] = MarkAttendanceResult::AlreadyMarked;
+            continue;
+        }
+
+        rows.push_back({key, {0, classId, entry.status}});
+        results[i] = MarkAttendanceResult::Marked;
+    }
+
+    for (auto& row : rows) {
+        row.second.attendanceId = store->nextAttendanceId++;
+        auto& counters = store->summary[{get<0>(row.first), get<1>(row.first)}];
+        counters.total += 1;
+        counters.present += isPresent(row.second.status) ? 1 : 0;
+        store->attendance.insert(move(row));
+    }
+    return results;
+}
+
+vector<AttendanceRecord> MemoryDatabase::getStudentAttendance(int studentId) {
+    vector<AttendanceRecord> records;
+    forEachStudentAttendance(studentId, [&records](const AttendanceRecord& record) {
+        records.push_back(record);
+        return true;
+    });
+    return records;
+}
+
+vector<AttendanceRecord> MemoryDatabase::getRecentAttendance(int studentId, int limit) {
+    vector<pair<int, AttendanceRecord>> rows;  // (attendance id, record)
+    {
+        ReadLock read(store->lock);
+        auto it = store->attendance.lower_bound({studentId, 0, 0});
+        auto end = store->attendance.lower_bound({studentId + 1, 0, 0});
+        for (; it != end; ++it) {
+            AttendanceRecord record;
+            record.studentId = studentId;
+            record.subjectId = get<1>(it->first);
+            record.date = Date::fromDays(get<2>(it->first));
+            record.status = parseAttendanceStatus(it->second.status);
+            record.subjectName = store->subjects.at(record.subjectId).name;
+            rows.push_back({it->second.attendanceId, move(record)});
+        }
+    }
+
+    // ORDER BY attendance_date DESC, attendance_id DESC
+    sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        if (a.second.date != b.second.date) return b.second.date < a.second.date;
+        return a.first > b.first;
+    });
+
+    vector<AttendanceRecord> records;
+    for (size_t i = 0; i < rows.size() && static_cast<int>(i) < limit; ++i) {
+        records.push_back(move(rows[i].second));
+    }
+    return records;
+}
+
+vector<AttendanceRecord> MemoryDatabase::getClassAttendance(int classId) {
+    vector<AttendanceRecord> records;
+    forEachClassAttendance(classId, [&records](const AttendanceRecord& record) {
+        records.push_back(record);
+        return true;
+    });
+    return records;
+}
+
+bool MemoryDatabase::forEachStudentAttendance(int studentId, const AttendanceVisitor& visitor) {
+    vector<AttendanceRecord> records;
+    {
+        ReadLock read(store->lock);
+        auto it = store->attendance.lower_bound({studentId, 0, 0});
+        auto end = store->attendance.lower_bound({studentId + 1, 0, 0});
+        for (; it != end; ++it) {
+            AttendanceRecord record;
+            record.studentId = studentId;
+            record.subjectId = get<1>(it->first);
+            record.date = Date::fromDays(get<2>(it->first));
+            record.status = parseAttendanceStatus(it->second.status);
+            record.subjectName = store->subjects.at(record.subjectId).name;
+            records.push_back(move(record));
+        }
+    }
+
+    stable_sort(records.begin(), records.end(), [](const AttendanceRecord& a, const AttendanceRecord& b) {
+        return a.date < b.date;
+    });
+
+    for (const auto& record : records) {
+        if (!visitor(record)) break;
+    }
+    return true;
+}
+
+bool MemoryDatabase::forEachClassAttendance(int classId, const AttendanceVisitor& visitor) {
+    vector<AttendanceRecord> records;
+    {
+        ReadLock read(store->lock);
+        for (const auto& entry : store->attendance) {
+            if (entry.second.classId != classId) continue;
+            AttendanceRecord record;
+            record.studentId = get<0>(entry.first);
+            record.subjectId = get<1>(entry.first);
+            record.date = Date::fromDays(get<2>(entry.first));
+            record.status = parseAttendanceStatus(entry.second.status);
+            record.studentName = store->students.at(record.studentId).name;
+            record.subjectName = store->subjects.at(record.subjectId).name;
+            records.push_back(move(record));
+        }
+    }
+
+    stable_sort(records.begin(), records.end(), [](const AttendanceRecord& a, const AttendanceRecord& b) {
+        return a.date < b.date;
+    });
+
+    for (const auto& record : records) {
+        if (!visitor(record)) break;
+    }
+    return true;
+}
+
+vector<AttendanceRecord> MemoryDatabase::getClassAttendancePage(int classId, const AttendanceRecord& after,
+                                                               int limit) {
+    auto key = [](const AttendanceRecord& r) { return make_tuple(r.date.daysSinceEpoch(), r.studentId, r.subjectId); };
+    bool first = !after.date.isValid();
+    vector<AttendanceRecord> records;
+    {
+        ReadLock read(store->lock);
+        for (const auto& entry : store->attendance) {
+            if (entry.second.classId != classId) continue;
+            AttendanceRecord record;
+            record.studentId = get<0>(entry.first);
+            record.subjectId = get<1>(entry.first);
+            record.date = Date::fromDays(get<2>(entry.first));
+            if (!first && key(record) <= key(after)) continue;
+            record.status = parseAttendanceStatus(entry.second.status);
+            record.studentName = store->students.at(record.studentId).name;
+            record.subjectName = store->subjects.at(record.subjectId).name;
+            records.push_back(move(record));
+        }
+    }
+
+    auto byKey = [&key](const AttendanceRecord& a, const AttendanceRecord& b) { return key(a) < key(b); };
+    size_t count = min(records.size(), static_cast<size_t>(max(limit, 0)));
+    partial_sort(records.begin(), records.begin() + count, records.end(), byKey);
+    records.resize(count);
+    return records;
+}
+
+double MemoryDatabase::getAttendancePercentage(int studentId, int subjectId) {
+    ReadLock read(store->lock);
+    AttendanceSummary summary;
+
+    if (subjectId > 0) {
+        auto it = store->summary.find({studentId, subjectId});
+        if (it != store->summary.end()) {
+            summary.total = it->second.total;
+            summary.present = it->second.present;
+        }
+    } else {
+        auto it = store->summary.lower_bound({studentId, 0});
+        for (; it != store->summary.end() && it->first.first == studentId; ++it) {
+            summary.total += it->second.total;
+            summary.present += it->second.present;
+        }
+    }
+    return summary.percentage();
+}
+
+vector<AttendanceSummary> MemoryDatabase::getAttendanceSummary(int studentId) {
+    vector<AttendanceSummary> summaries;
+    {
+        ReadLock read(store->lock);
+        auto it = store->summary.lower_bound({studentId, 0});
+        for (; it != store->summary.end() && it->first.first == studentId; ++it) {
+            if (it->second.total <= 0) continue;
+            AttendanceSummary summary;
+            summary.studentId = studentId;
+            summary.subjectId = it->first.second;
+            summary.subjectName = store->subjects.at(summary.subjectId).name;
+            summary.total = it->second.total;
+            summary.present = it->second.present;
+            summaries.push_back(move(summary));
+        }
+    }
+
+    sort(summaries.begin(), summaries.end(), [](const AttendanceSummary& a, const AttendanceSummary& b) {
+        return a.subjectName < b.subjectName;
+    });
+    return summaries;
+}
+
+bool MemoryDatabase::rebuildAttendanceSummary() {
+    WriteLock write(store->lock);
+    store->summary.clear();
+    for (const auto& entry : store->attendance) {
+        auto& counters = store->summary[{get<0>(entry.first), get<1>(entry.first)}];
+        counters.total += 1;
+        counters.present += isPresent(entry.second.status) ? 1 : 0;
+    }
+    return true;
+}
+
+vector<SessionSheetEntry> MemoryDatabase::getClassSessionSheet(int classId, int subjectId, const Date& date) {
+    ReadLock read(store->lock);
+    vector<SessionSheetEntry> sheet;
+    for (const auto& entry : store->students) {
+        if (entry.second.classId != classId || classId == 0) continue;
+
+        SessionSheetEntry line;
+        line.studentId = entry.first;
+        line.studentName = entry.second.name;
+        if (date.isValid()) {
+            auto mark = store->attendance.find({entry.first, subjectId, date.daysSinceEpoch()});
+            if (mark != store->attendance.end()) {
+                line.marked = true;
+                line.status = parseAttendanceStatus(mark->second.status);
+            }
+        }
+        sheet.push_back(move(line));
+    }
+    return sheet;
+}
+
+bool MemoryDatabase::addSubjectToClass(int classId, int subjectId) {
+    WriteLock write(store->lock);
+    if (!store->classes.count(classId) || !store->subjects.count(subjectId)) {
+        foreignKeyFails("class_subjects");
+        return false;
+    }
+
+    if (!store->classSubjects.insert({classId, subjectId}).second) {
+        duplicateEntry("unique_class_subject");
+        return false;
+    }
+    return true;
+}
+
+vector<Subject> MemoryDatabase::getClassSubjects(int classId) {
+    ReadLock read(store->lock);
+    vector<Subject> subjects;
+    auto it = store->classSubjects.lower_bound({classId, 0});
+    for (; it != store->classSubjects.end() && it->first == classId; ++it) {
+        subjects.push_back(store->subjects.at(it->second));
+    }
+    return subjects;
+}
+
+unordered_map<int, vector<Subject>> MemoryDatabase::getAllClassSubjects() {
+    ReadLock read(store->lock);
+    unordered_map<int, vector<Subject>> classSubjects;
+    for (const auto& pair : store->classSubjects) {
+        classSubjects[pair.first].push_back(store->subjects.at(pair.second));
+    }
+    return classSubjects;
+}
@@ -0,0 +1,211 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+namespace {
+
+// Each thread sticks to one shard, handed out round-robin
+size_t shardIndex() {
+    static atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, memory_order_relaxed) % metricShards;
+    return shard;
+}
+
+string formatNumber(double value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+}
+
+void appendHeader(string& out, const string& name, const string& help, const char* type) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+} // namespace
+
+string escapeLabelValue(const string& value) {
+    string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void Counter::add(uint64_t n) {
+    shards[shardIndex()].value.fetch_add(n, memory_order_relaxed);
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard.value.load(memory_order_relaxed);
+    }
+    return total;
+}
+
+void Histogram::observe(chrono::nanoseconds elapsed) {
+    uint64_t nanos = static_cast<uint64_t>(max<int64_t>(elapsed.count(), 0));
+    uint64_t micros = (nanos + 999) / 1000;
+    // Smallest i with micros <= 2^i
+    int bucket = micros <= 1 ? 0 : 64 - __builtin_clzll(micros - 1);
+
+    Shard& shard = shards[shardIndex()];
+    shard.buckets[min(bucket, bucketCount)].fetch_add(1, memory_order_relaxed);
+    shard.sumNanos.fetch_add(nanos, memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snap;
+    uint64_t sumNanos = 0;
+    for (const auto& shard : shards) {
+        for (int i = 0; i <= bucketCount; ++i) {
+            uint64_t n = shard.buckets[i].load(memory_order_relaxed);
+            snap.buckets[i] += n;
+            snap.count += n;
+        }
+        sumNanos += shard.sumNanos.load(memory_order_relaxed);
+    }
+    snap.sumSeconds = sumNanos / 1e9;
+    return snap;
+}
+
+HistogramFamily::HistogramFamily(const string& name, const string& help,
+                                 const string& label1, const string& label2)
+    : name(name), help(help), label1(label1), label2(label2) {
+    for (auto& slot : slots) {
+        slot.store(nullptr, memory_order_relaxed);
+    }
+    overflow = makeSeries("other", label2.empty() ? "" : "other");
+}
+
+HistogramFamily::~HistogramFamily() {
+    for (auto& slot : slots) {
+        delete slot.load(memory_order_relaxed);
+    }
+}
+
+unique_ptr<HistogramFamily::Series> HistogramFamily::makeSeries(const string& value1, const string& value2) const {
+    auto series = make_unique<Series>();
+    series->value1 = value1;
+    series->value2 = value2;
+    if (!label1.empty()) {
+        series->labels = label1 + "=\"" + escapeLabelValue(value1) + "\"";
+    }
+    if (!label2.empty()) {
+        series->labels += "," + label2 + "=\"" + escapeLabelValue(value2) + "\"";
+    }
+    return series;
+}
+
+Histogram& HistogramFamily::get(const string& value1, const string& value2) {
+    size_t start = hash<string>()(value1) ^ (hash<string>()(value2) * 0x9e3779b97f4a7c15ULL);
+    unique_ptr<Series> fresh;
+
+    for (size_t probe = 0; probe < capacity; ++probe) {
+        auto& slot = slots[(start + probe) % capacity];
+        Series* series = slot.load(memory_order_acquire);
+
+        if (series == nullptr) {
+            if (!fresh) fresh = makeSeries(value1, value2);
+            if (slot.compare_exchange_strong(series, fresh.get(), memory_order_acq_rel)) {
+                return fresh.release()->histogram;
+            }
+            // Lost the race; `series` now holds the winner
+        }
+        if (series->value1 == value1 && series->value2 == value2) {
+            return series->histogram;
+        }
+    }
+    return overflow->histogram;
+}
+
+void HistogramFamily::render(string& out) const {
+    vector<const Series*> series;
+    for (const auto& slot : slots) {
+        if (const Series* s = slot.load(memory_order_acquire)) series.push_back(s);
+    }
+    sort(series.begin(), series.end(), [](const Series* a, const Series* b) { return a->labels < b->labels; });
+    if (overflow->histogram.snapshot().count > 0) series.push_back(overflow.get());
+
+    appendHeader(out, name, help, "histogram");
+    for (const Series* s : series) {
+        Histogram::Snapshot snap = s->histogram.snapshot();
+        string prefix = s->labels.empty() ? "{" : "{" + s->labels + ",";
+        string suffix = s->labels.empty() ? "" : "{" + s->labels + "}";
+
+        uint64_t cumulative = 0;
+        for (int i = 0; i < Histogram::bucketCount; ++i) {
+            cumulative += snap.buckets[i];
+            out += name + "_bucket" + prefix + "le=\"" + formatNumber((uint64_t(1) << i) / 1e6) + "\"} " +
+                   to_string(cumulative) + "\n";
+        }
+        out += name + "_bucket" + prefix + "le=\"+Inf\"} " + to_string(snap.count) + "\n";
+        out += name + "_sum" + suffix + " " + formatNumber(snap.sumSeconds) + "\n";
+        out += name + "_count" + suffix + " " + to_string(snap.count) + "\n";
+    }
+}
+
+Counter& MetricsRegistry::counter(const string& name, const string& help) {
+    auto entry = make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = "counter";
+    entry->counter = make_unique<Counter>();
+    Counter& counter = *entry->counter;
+    entries.push_back(move(entry));
+    return counter;
+}
+
+HistogramFamily& MetricsRegistry::histograms(const string& name, const string& help,
+                                             const string& label1, const string& label2) {
+    auto entry = make_unique<Entry>();
+    entry->name = name;
+    entry->type = "histogram";
+    entry->family = make_unique<HistogramFamily>(name, help, label1, label2);
+    HistogramFamily& family = *entry->family;
+    entries.push_back(move(entry));
+    return family;
+}
+
+Histogram& MetricsRegistry::histogram(const string& name, const string& help) {
+    return histograms(name, help, "").get("");
+}
+
+void MetricsRegistry::gauge(const string& name, const string& help, function<double()> read) {
+    auto entry = make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = "gauge";
+    entry->read = move(read);
+    entries.push_back(move(entry));
+}
+
+void MetricsRegistry::counterFunction(const string& name, const string& help, function<double()> read) {
+    gauge(name, help, move(read));
+    entries.back()->type = "counter";
+}
+
+string MetricsRegistry::render() const {
+    string out;
+    for (const auto& entry : entries) {
+        if (entry->family) {
+            entry->family->render(out);
+            continue;
+        }
+        appendHeader(out, entry->name, entry->help, entry->type);
+        string value = entry->counter ? to_string(entry->counter->value()) : formatNumber(entry->read());
+        out += entry->name + " " + value + "\n";
+    }
+    return out;
+}
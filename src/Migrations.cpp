@@ -0,0 +1,148 @@
+#include "Migrations.h"
+#include <iostream>
+
+using namespace std;
+
+const vector<Migration>& Migrations::all() {
+    static const vector<Migration> migrations = {
+        {
+            1,
+            "Covering indexes for attendance access paths",
+            {
+                // Class-wide reports: WHERE class_id=? ORDER BY attendance_date
+                "CREATE INDEX idx_attendance_class_date ON attendance_records "
+                "(class_id, attendance_date, student_id, subject_id, status)",
+                // Percentages: WHERE student_id=? [AND subject_id=?] counting status
+                "CREATE INDEX idx_attendance_student_subject_status ON attendance_records "
+                "(student_id, subject_id, status, attendance_date)"
+            }
+        },
+        {
+            2,
+            "Per-student, per-subject attendance counters",
+            {
+                "CREATE TABLE attendance_summary ("
+                "student_id INT NOT NULL, "
+                "subject_id INT NOT NULL, "
+                "total INT NOT NULL DEFAULT 0, "
+                "present INT NOT NULL DEFAULT 0, "
+                "PRIMARY KEY (student_id, subject_id), "
+                "FOREIGN KEY (student_id) REFERENCES students(student_id) ON DELETE CASCADE, "
+                "FOREIGN KEY (subject_id) REFERENCES subjects(subject_id) ON DELETE CASCADE)",
+                // Seed from existing records; writers keep it current from here on
+                "INSERT INTO attendance_summary (student_id, subject_id, total, present) "
+                "SELECT student_id, subject_id, COUNT(*), "
+                "SUM(CASE WHEN status='Present' THEN 1 ELSE 0 END) "
+                "FROM attendance_records GROUP BY student_id, subject_id"
+            }
+        },
+    };
+    return migrations;
+}
+
+bool Migrations::run(MySqlDatabase& db) {
+    int current = db.getSchemaVersion();
+    if (current < 0) {
+        cerr << "Migrations: could not read schema version" << endl;
+        return false;
+    }
+
+    for (const auto& migration : all()) {
+        if (migration.version <= current) continue;
+
+        cout << "Applying migration " << migration.version << ": " << migration.description << endl;
+
+        // DDL commits implicitly in MySQL, so a failed migration is reported
+        // and left for the operator rather than rolled back
+        for (const auto& statement : migration.statements) {
+            if (!db.executeSql(statement)) {
+                cerr << "Migration " << migration.version << " failed" << endl;
+                return false;
+            }
+        }
+
+        if (!db.recordMigration(migration.version, migration.description)) {
+            return false;
+        }
+        current = migration.version;
+    }
+
+    cout << "Schema is at version " << current << endl;
+    return true;
+}
+
+bool Migrations::checkQueryPlans(MySqlDatabase& db) {
+    // Representative literals for the parameterised queries in MySqlDatabase.cpp
+    static const vector<string> hotQueries = {
+        "SELECT s.student_id, s.name, s.class_id, c.class_name "
+        "FROM students s LEFT JOIN classes c ON s.class_id = c.class_id WHERE s.student_id=1",
+
+        "SELECT student_id, name, class_id FROM students WHERE class_id=1",
+
+        "SELECT s.subject_id, s.name, s.max_marks FROM class_subjects cs "
+        "JOIN subjects s ON cs.subject_id = s.subject_id WHERE cs.class_id=1",
+
+        "SELECT attendance_id FROM attendance_records "
+        "WHERE student_id=1 AND subject_id=1 AND attendance_date='2025-01-01'",
+
+        "SELECT ar.attendance_date, s.name, ar.status, ar.subject_id FROM attendance_records ar "
+        "JOIN subjects s ON ar.subject_id = s.subject_id WHERE ar.student_id=1 ORDER BY ar.attendance_date",
+
+        "SELECT ar.attendance_date, ar.student_id, st.name, ar.subject_id, s.name, ar.status "
+        "FROM attendance_records ar JOIN students st ON ar.student_id = st.student_id "
+        "JOIN subjects s ON ar.subject_id = s.subject_id WHERE ar.class_id=1 ORDER BY ar.attendance_date",
+
+        "SELECT ar.attendance_date, ar.student_id, st.name, ar.subject_id, s.name, ar.status "
+        "FROM attendance_records ar JOIN students st ON ar.student_id = st.student_id "
+        "JOIN subjects s ON ar.subject_id = s.subject_id WHERE ar.class_id=1 "
+        "AND (ar.attendance_date, ar.student_id, ar.subject_id) > ('2025-01-01', 1, 1) "
+        "ORDER BY ar.attendance_date, ar.student_id, ar.subject_id LIMIT 2000",
+
+        "SELECT ar.attendance_date, s.name, ar.status, ar.subject_id FROM attendance_records ar "
+        "JOIN subjects s ON ar.subject_id = s.subject_id WHERE ar.student_id=1 "
+        "ORDER BY ar.attendance_date DESC, ar.attendance_id DESC LIMIT 10",
+
+        "SELECT total, present FROM attendance_summary WHERE student_id=1 AND subject_id=1",
+
+        "SELECT sm.subject_id, s.name, sm.total, sm.present FROM attendance_summary sm "
+        "JOIN subjects s ON sm.subject_id = s.subject_id WHERE sm.student_id=1 AND sm.total > 0",
+
+        "SELECT COALESCE(SUM(total), 0), COALESCE(SUM(present), 0) "
+        "FROM attendance_summary WHERE student_id=1",
+
+        "SELECT s.student_id, s.name, ar.status FROM students s "
+        "LEFT JOIN attendance_records ar ON ar.student_id = s.student_id "
+        "AND ar.subject_id=1 AND ar.attendance_date='2025-01-01' "
+        "WHERE s.class_id=1 ORDER BY s.student_id",
+
+        "SELECT tsa.subject_id, s.name, tsa.class_id, c.class_name FROM teacher_subject_assignments tsa "
+        "JOIN subjects s ON tsa.subject_id = s.subject_id JOIN classes c ON tsa.class_id = c.class_id "
+        "WHERE tsa.teacher_id=1",
+
+        "SELECT tca.class_id, c.class_name FROM teacher_class_assignments tca "
+        "JOIN classes c ON tca.class_id = c.class_id WHERE tca.teacher_id=1"
+    };
+
+    bool ok = true;
+    for (const auto& query : hotQueries) {
+        auto plan = db.explainQuery(query);
+        if (plan.empty()) {
+            cerr << "FAIL (no plan): " << query << endl;
+            ok = false;
+            continue;
+        }
+
+        for (const auto& step : plan) {
+            auto type = step.find("type");
+            if (type != step.end() && type->second == "ALL") {
+                auto table = step.find("table");
+                cerr << "FAIL full scan of " << (table != step.end() ? table->second : "?")
+                     << ": " << query << endl;
+                ok = false;
+            }
+        }
+    }
+
+    cout << (ok ? "All hot queries use indexes" : "Some hot queries scan whole tables") << endl;
+    return ok;
+}
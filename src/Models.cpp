@@ -0,0 +1,55 @@
+#include "Models.h"
+#include <cctype>
+#include <ctime>
+
+using namespace std;
+
+namespace {
+
+bool equalsIgnoreCase(const string& a, const char* b) {
+    size_t i = 0;
+    for (; i < a.size() && b[i] != '\0'; ++i) {
+        if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return i == a.size() && b[i] == '\0';
+}
+
+} // namespace
+
+// Compile-time checks of the calendar arithmetic
+static_assert(Date::parse("1970-01-01", 10).daysSinceEpoch() == 0, "epoch");
+static_assert(Date::parse("2024-02-29", 10).isValid() && !Date::parse("2025-02-29", 10).isValid(), "leap years");
+static_assert(Date::parse("2000-03-01", 10).addDays(-1) == Date::fromCivil(2000, 2, 29), "century leap year");
+static_assert(Date::fromCivil(2025, 1, 1).weekday() == Weekday::Wednesday, "weekday");
+static_assert(Date::fromCivil(1969, 12, 31).day() == 31 && Date::fromCivil(9999, 12, 31).year() == 9999, "round trip");
+
+Date Date::today() {
+    time_t now = time(nullptr);
+    tm local{};
+    localtime_r(&now, &local);
+    return fromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+string Date::toString() const {
+    char buffer[10];
+    format(buffer);
+    return string(buffer, sizeof(buffer));
+}
+
+AttendanceStatus parseAttendanceStatus(const string& text) {
+    if (equalsIgnoreCase(text, "Present")) return AttendanceStatus::Present;
+    if (equalsIgnoreCase(text, "Absent")) return AttendanceStatus::Absent;
+    if (equalsIgnoreCase(text, "Late")) return AttendanceStatus::Late;
+    return AttendanceStatus::Unknown;
+}
+
+const char* toString(AttendanceStatus status) {
+    switch (status) {
+        case AttendanceStatus::Present: return "Present";
+        case AttendanceStatus::Absent: return "Absent";
+        case AttendanceStatus::Late: return "Late";
+        default: return "Unknown";
+    }
+}
@@ -0,0 +1,1832 @@
+#include "MySqlDatabase.h"
+#include <mysql/mysqld_error.h>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <type_traits>
+#include <unordered_set>
+#include <set>
+#include <tuple>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+// MySQL 8 declares MYSQL_BIND::is_null as bool*, MariaDB/older as my_bool*
+using BindFlag = remove_pointer_t<decltype(MYSQL_BIND::is_null)>;
+
+MYSQL_BIND intParam(const int& value) {
+    MYSQL_BIND bind;
+    memset(&bind, 0, sizeof(bind));
+    bind.buffer_type = MYSQL_TYPE_LONG;
+    bind.buffer = const_cast<int*>(&value);
+    return bind;
+}
+
+MYSQL_BIND stringParam(const string& value) {
+    MYSQL_BIND bind;
+    memset(&bind, 0, sizeof(bind));
+    bind.buffer_type = MYSQL_TYPE_STRING;
+    bind.buffer = const_cast<char*>(value.data());
+    bind.buffer_length = value.size();
+    return bind;
+}
+
+// Output buffers for prepared statement results
+struct IntColumn {
+    int value = 0;
+    BindFlag isNull = 0;
+    
+    MYSQL_BIND bind() {
+        MYSQL_BIND b;
+        memset(&b, 0, sizeof(b));
+        b.buffer_type = MYSQL_TYPE_LONG;
+        b.buffer = &value;
+        b.is_null = &isNull;
+        return b;
+    }
+    int get() const { return isNull ? 0 : value; }
+};
+
+// A text column read into an inline buffer. A longer value (a utf8mb4
+// VARCHAR(255) can take 1020 bytes) is fetched again in full by str()
+// rather than being cut, possibly mid-character.
+struct TextColumn {
+    char data[256];
+    unsigned long length = 0;  // the value's full length, even if it didn't fit
+    BindFlag isNull = 0;
+    const unsigned column;     // position in the result row, for the refetch
+    
+    explicit TextColumn(unsigned column) : column(column) {}
+    
+    MYSQL_BIND bind() {
+        MYSQL_BIND b;
+        memset(&b, 0, sizeof(b));
+        b.buffer_type = MYSQL_TYPE_STRING;
+        b.buffer = data;
+        b.buffer_length = sizeof(data);
+        b.length = &length;
+        b.is_null = &isNull;
+        return b;
+    }
+    // Call after fetchRow and before the next fetch on `stmt`
+    string str(MYSQL_STMT* stmt, const char* fallback = "") const {
+        if (isNull) return fallback;
+        if (length <= sizeof(data)) return string(data, length);
+        
+        string value(length, '\0');
+        unsigned long fetched = 0;
+        MYSQL_BIND b;
+        memset(&b, 0, sizeof(b));
+        b.buffer_type = MYSQL_TYPE_STRING;
+        b.buffer = &value[0];
+        b.buffer_length = length;
+        b.length = &fetched;
+        if (mysql_stmt_fetch_column(stmt, &b, column, 0) != 0) {
+            cerr << "Column fetch failed: " << mysql_stmt_error(stmt) << endl;
+            return fallback;
+        }
+        return value;
+    }
+};
+
+struct DateColumn {
+    MYSQL_TIME value;
+    BindFlag isNull = 0;
+    
+    MYSQL_BIND bind() {
+        MYSQL_BIND b;
+        memset(&b, 0, sizeof(b));
+        memset(&value, 0, sizeof(value));
+        b.buffer_type = MYSQL_TYPE_DATE;
+        b.buffer = &value;
+        b.is_null = &isNull;
+        return b;
+    }
+    Date date() const {
+        if (isNull) return Date();
+        return Date::fromCivil(static_cast<int>(value.year), static_cast<int>(value.month),
+                               static_cast<int>(value.day));
+    }
+};
+
+// Input buffer for a DATE parameter; keep it alive until the statement runs
+struct DateParam {
+    MYSQL_TIME value;
+    
+    explicit DateParam(const Date& date) {
+        memset(&value, 0, sizeof(value));
+        if (date.isValid()) {
+            value.year = static_cast<unsigned int>(date.year());
+            value.month = static_cast<unsigned int>(date.month());
+            value.day = static_cast<unsigned int>(date.day());
+        }
+        value.time_type = MYSQL_TIMESTAMP_DATE;
+    }
+    
+    MYSQL_BIND bind() {
+        MYSQL_BIND b;
+        memset(&b, 0, sizeof(b));
+        b.buffer_type = MYSQL_TYPE_DATE;
+        b.buffer = &value;
+        return b;
+    }
+};
+
+// Text-protocol column conversions (NULL -> 0 / empty)
+int toInt(const char* value) {
+    return value ? static_cast<int>(strtol(value, nullptr, 10)) : 0;
+}
+
+double toDouble(const char* value) {
+    return value ? strtod(value, nullptr) : 0.0;
+}
+
+Date toDate(const char* value) {
+    return value ? Date::parse(value, strlen(value)) : Date();
+}
+
+// MYSQL_DATA_TRUNCATED only means a text value outgrew its TextColumn
+// buffer; TextColumn::str() reads it in full
+bool fetchRow(MYSQL_STMT* stmt) {
+    int rc = mysql_stmt_fetch(stmt);
+    return rc == 0 || rc == MYSQL_DATA_TRUNCATED;
+}
+
+} // namespace
+
+MySqlDatabase::MySqlDatabase(const map<string, string>& config) : connectionConfig(config) {
+    conn = mysql_init(nullptr);
+    
+    if (conn == nullptr) {
+        cerr << "MySQL initialization failed" << endl;
+        return;
+    }
+    
+    // Set connection timeout
+    unsigned int timeout = 28800; // 8 hours
+    mysql_options(conn, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
+    mysql_options(conn, MYSQL_OPT_READ_TIMEOUT, &timeout);
+    mysql_options(conn, MYSQL_OPT_WRITE_TIMEOUT, &timeout);
+    
+    string host = config.count("host") ? config.at("host") : "localhost";
+    string user = config.count("user") ? config.at("user") : "root";
+    string password = config.count("password") ? config.at("password") : "";
+    string database = config.count("database") ? config.at("database") : "attendance_system";
+    int port = config.count("port") ? stoi(config.at("port")) : 3306;
+    
+    if (mysql_real_connect(conn, host.c_str(), user.c_str(), password.c_str(), 
+                           database.c_str(), port, nullptr, 0) == nullptr) {
+        cerr << "Connection failed: " << mysql_error(conn) << endl;
+        mysql_close(conn);
+        conn = nullptr;
+    }
+}
+
+MySqlDatabase::~MySqlDatabase() {
+    closeStatements();
+    if (conn != nullptr) {
+        mysql_close(conn);
+    }
+}
+
+bool MySqlDatabase::isConnected() const {
+    return conn != nullptr;
+}
+
+bool MySqlDatabase::lastQueryFailed() const {
+    // A failed reconnect leaves no connection at all
+    return conn == nullptr || mysql_errno(conn) != 0;
+}
+
+atomic<uint64_t> MySqlDatabase::reconnectCount{0};
+
+bool MySqlDatabase::reconnect() {
+    reconnectCount.fetch_add(1, memory_order_relaxed);
+    
+    // Statements die with the connection; they are re-prepared lazily on next use
+    closeStatements();
+    
+    // Close existing connection if it exists
+    if (conn != nullptr) {
+        mysql_close(conn);
+        conn = nullptr;
+    }
+    
+    conn = mysql_init(nullptr);
+    if (conn == nullptr) {
+        cerr << "MySQL re-initialization failed" << endl;
+        return false;
+    }
+    
+    // Set connection timeout
+    unsigned int timeout = 28800;
+    mysql_options(conn, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
+    mysql_options(conn, MYSQL_OPT_READ_TIMEOUT, &timeout);
+    mysql_options(conn, MYSQL_OPT_WRITE_TIMEOUT, &timeout);
+    
+    if (connectionConfig.empty()) {
+        cerr << "Connection configuration is empty" << endl;
+        mysql_close(conn);
+        conn = nullptr;
+        return false;
+    }
+    
+    string host = connectionConfig.count("host") ? connectionConfig.at("host") : "localhost";
+    string user = connectionConfig.count("user") ? connectionConfig.at("user") : "root";
+    string password = connectionConfig.count("password") ? connectionConfig.at("password") : "";
+    string database = connectionConfig.count("database") ? connectionConfig.at("database") : "attendance_system";
+    int port = connectionConfig.count("port") ? stoi(connectionConfig.at("port")) : 3306;
+    
+    if (mysql_real_connect(conn, host.c_str(), user.c_str(), password.c_str(),
+                           database.c_str(), port, nullptr, 0) == nullptr) {
+        string error = mysql_error(conn);
+        cerr << "Reconnection failed: " << error << endl;
+        mysql_close(conn);
+        conn = nullptr;
+        return false;
+    }
+    
+    cout << "Database reconnected successfully" << endl;
+    return true;
+}
+
+bool MySqlDatabase::ensureConnection() {
+    if (conn == nullptr) {
+        return reconnect();
+    }
+    
+    // Ping the connection to check if it's alive
+    if (mysql_ping(conn) != 0) {
+        cerr << "Connection lost (ping failed), attempting to reconnect..." << endl;
+        return reconnect();
+    }
+    
+    return true;
+}
+
+MYSQL_STMT* MySqlDatabase::prepareStatement(const char* sql) {
+    auto it = statements.find(sql);
+    if (it != statements.end()) {
+        return it->second;
+    }
+    
+    MYSQL_STMT* stmt = mysql_stmt_init(conn);
+    if (stmt == nullptr) {
+        cerr << "Statement init failed: " << mysql_error(conn) << endl;
+        return nullptr;
+    }
+    
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql))) {
+        cerr << "Prepare failed: " << mysql_stmt_error(stmt) << endl;
+        mysql_stmt_close(stmt);
+        return nullptr;
+    }
+    
+    statements[sql] = stmt;
+    return stmt;
+}
+
+bool MySqlDatabase::executeStatement(MYSQL_STMT* stmt, MYSQL_BIND* params, MYSQL_BIND* results,
+                                bool buffered) {
+    if (stmt == nullptr) return false;
+    
+    if (params != nullptr && mysql_stmt_bind_param(stmt, params)) {
+        cerr << "Bind failed: " << mysql_stmt_error(stmt) << endl;
+        return false;
+    }
+    
+    if (mysql_stmt_execute(stmt)) {
+        cerr << "Statement failed: " << mysql_stmt_error(stmt) << endl;
+        return false;
+    }
+    
+    // Unbuffered results are pulled from the socket row by row by mysql_stmt_fetch
+    if (results != nullptr) {
+        if (mysql_stmt_bind_result(stmt, results) || (buffered && mysql_stmt_store_result(stmt))) {
+            cerr << "Result binding failed: " << mysql_stmt_error(stmt) << endl;
+            mysql_stmt_free_result(stmt);
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void MySqlDatabase::closeStatements() {
+    for (auto& entry : statements) {
+        mysql_stmt_close(entry.second);
+    }
+    statements.clear();
+}
+
+bool MySqlDatabase::beginTransaction() {
+    if (mysql_query(conn, "START TRANSACTION")) {
+        cerr << "Transaction failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    return true;
+}
+
+bool MySqlDatabase::commitTransaction() {
+    if (mysql_commit(conn)) {
+        cerr << "Commit failed: " << mysql_error(conn) << endl;
+        mysql_rollback(conn);
+        return false;
+    }
+    return true;
+}
+
+void MySqlDatabase::rollbackTransaction() {
+    mysql_rollback(conn);
+}
+
+bool MySqlDatabase::bumpAttendanceSummary(int studentId, int subjectId, bool present) {
+    static const char* sql = "INSERT INTO attendance_summary (student_id, subject_id, total, present) "
+                             "VALUES (?, ?, 1, ?) "
+                             "ON DUPLICATE KEY UPDATE total = total + 1, present = present + VALUES(present)";
+    
+    MYSQL_BIND params[] = { intParam(studentId), intParam(subjectId), intParam(present ? 1 : 0) };
+    return executeStatement(prepareStatement(sql), params, nullptr);
+}
+
+string MySqlDatabase::escapeString(const string& str) {
+    // Return input unchanged if no connection (prevent segfault)
+    if (conn == nullptr) {
+        return str;
+    }
+    
+    char* escaped = new char[str.length() * 2 + 1];
+    mysql_real_escape_string(conn, escaped, str.c_str(), str.length());
+    string result(escaped);
+    delete[] escaped;
+    return result;
+}
+
+// Authentication
+bool MySqlDatabase::authenticateAdmin(const string& email, const string& password) {
+    if (!ensureConnection()) {
+        cerr << "Database connection unavailable" << endl;
+        return false;
+    }
+    
+    string query = "SELECT * FROM admins WHERE email='" + escapeString(email) + 
+                       "' AND password='" + escapeString(password) + "'";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool authenticated = (mysql_num_rows(result) > 0);
+    mysql_free_result(result);
+    
+    return authenticated;
+}
+
+optional<Teacher> MySqlDatabase::authenticateTeacher(const string& email, const string& password) {
+    if (!ensureConnection()) {
+        cerr << "Database connection unavailable" << endl;
+        return nullopt;
+    }
+    
+    string query = "SELECT teacher_id, name, teacher_type FROM teachers WHERE email='" + 
+                       escapeString(email) + "' AND password='" + escapeString(password) + "'";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return nullopt;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    optional<Teacher> teacher;
+    if (MYSQL_ROW row = mysql_fetch_row(result)) {
+        teacher.emplace();
+        teacher->id = toInt(row[0]);
+        teacher->name = row[1] ? row[1] : "";
+        teacher->email = email; // Pass back the email used for login
+        teacher->type = row[2] ? row[2] : "";
+    }
+    mysql_free_result(result);
+    
+    return teacher;
+}
+
+// CRUD - Subjects
+int MySqlDatabase::createSubject(const string& name, int maxMarks) {
+    if (!ensureConnection()) return -1;
+    
+    string query = "INSERT INTO subjects (name, max_marks) VALUES ('" + 
+                       escapeString(name) + "', " + to_string(maxMarks) + ")";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Insert failed: " << mysql_error(conn) << endl;
+        return -1;
+    }
+    
+    return mysql_insert_id(conn);
+}
+
+vector<Subject> MySqlDatabase::getAllSubjects() {
+    vector<Subject> subjects;
+    if (!ensureConnection()) return subjects;
+    
+    if (mysql_query(conn, "SELECT subject_id, name, max_marks FROM subjects")) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return subjects;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    subjects.reserve(mysql_num_rows(result));
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        Subject subject;
+        subject.id = toInt(row[0]);
+        subject.name = row[1] ? row[1] : "";
+        subject.maxMarks = toInt(row[2]);
+        subjects.push_back(move(subject));
+    }
+    
+    mysql_free_result(result);
+    return subjects;
+}
+
+optional<Subject> MySqlDatabase::getSubjectById(int id) {
+    if (!ensureConnection()) return nullopt;
+    
+    string query = "SELECT subject_id, name, max_marks FROM subjects WHERE subject_id=" + to_string(id);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return nullopt;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    optional<Subject> subject;
+    if (MYSQL_ROW row = mysql_fetch_row(result)) {
+        subject.emplace();
+        subject->id = toInt(row[0]);
+        subject->name = row[1] ? row[1] : "";
+        subject->maxMarks = toInt(row[2]);
+    }
+    mysql_free_result(result);
+    
+    return subject;
+}
+
+// CRUD - Classes
+int MySqlDatabase::createClass(const string& className) {
+    if (!ensureConnection()) return -1;
+    
+    string query = "INSERT INTO classes (class_name) VALUES ('" + 
+                       escapeString(className) + "')";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Insert failed: " << mysql_error(conn) << endl;
+        return -1;
+    }
+    
+    return mysql_insert_id(conn);
+}
+
+vector<ClassInfo> MySqlDatabase::getAllClasses() {
+    vector<ClassInfo> classes;
+    if (!ensureConnection()) return classes;
+    
+    if (mysql_query(conn, "SELECT class_id, class_name FROM classes")) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return classes;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    classes.reserve(mysql_num_rows(result));
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        ClassInfo cls;
+        cls.id = toInt(row[0]);
+        cls.name = row[1] ? row[1] : "";
+        classes.push_back(move(cls));
+    }
+    
+    mysql_free_result(result);
+    return classes;
+}
+
+optional<ClassInfo> MySqlDatabase::getClassById(int id) {
+    if (!ensureConnection()) return nullopt;
+    
+    string query = "SELECT class_id, class_name FROM classes WHERE class_id=" + to_string(id);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return nullopt;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    optional<ClassInfo> cls;
+    if (MYSQL_ROW row = mysql_fetch_row(result)) {
+        cls.emplace();
+        cls->id = toInt(row[0]);
+        cls->name = row[1] ? row[1] : "";
+    }
+    mysql_free_result(result);
+    
+    return cls;
+}
+
+// CRUD - Teachers
+int MySqlDatabase::createTeacher(const string& name, const string& email, 
+                           const string& password, double salary, 
+                           const Date& joinDate, const string& type) {
+    if (!ensureConnection()) return -1;
+    
+    string query = string("INSERT INTO teachers (name, email, password, salary, join_date, teacher_type) VALUES ('") +
+                       escapeString(name) + "', '" + escapeString(email) + "', '" +
+                       escapeString(password) + "', " + to_string(salary) + ", '" + 
+                       joinDate.toString() + "', '" + escapeString(type) + "')";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Insert failed: " << mysql_error(conn) << endl;
+        return -1;
+    }
+    
+    return mysql_insert_id(conn);
+}
+
+vector<Teacher> MySqlDatabase::getAllTeachers() {
+    vector<Teacher> teachers;
+    if (!ensureConnection()) return teachers;
+    
+    if (mysql_query(conn, "SELECT teacher_id, name, email, salary, join_date, teacher_type FROM teachers")) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return teachers;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    teachers.reserve(mysql_num_rows(result));
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        Teacher teacher;
+        teacher.id = toInt(row[0]);
+        teacher.name = row[1] ? row[1] : "";
+        teacher.email = row[2] ? row[2] : "";
+        teacher.salary = toDouble(row[3]);
+        teacher.joinDate = toDate(row[4]);
+        teacher.type = row[5] ? row[5] : "";
+        teachers.push_back(move(teacher));
+    }
+    
+    mysql_free_result(result);
+    return teachers;
+}
+
+vector<Teacher> MySqlDatabase::getAllTeachersWithDetails() {
+    vector<Teacher> teachers;
+    if (!ensureConnection()) return teachers;
+    
+    // Optimized query to fetch teacher details AND their class assignment in one go
+    string query = "SELECT t.teacher_id, t.name, t.email, t.salary, t.join_date, t.teacher_type, "
+                   "c.class_id, c.class_name "
+                   "FROM teachers t "
+                   "LEFT JOIN teacher_class_assignments tca ON t.teacher_id = tca.teacher_id "
+                   "LEFT JOIN classes c ON tca.class_id = c.class_id";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return teachers;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    teachers.reserve(mysql_num_rows(result));
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        Teacher teacher;
+        teacher.id = toInt(row[0]);
+        teacher.name = row[1] ? row[1] : "";
+        teacher.email = row[2] ? row[2] : "";
+        teacher.salary = toDouble(row[3]);
+        teacher.joinDate = toDate(row[4]);
+        teacher.type = row[5] ? row[5] : "";
+        
+        // Class info from JOIN
+        teacher.classId = toInt(row[6]);
+        teacher.className = row[7] ? row[7] : "";
+        
+        teachers.push_back(move(teacher));
+    }
+    
+    mysql_free_result(result);
+    return teachers;
+}
+
+optional<Teacher> MySqlDatabase::getTeacherById(int id) {
+    if (!ensureConnection()) return nullopt;
+    
+    string query = "SELECT teacher_id, name, email, salary, join_date, teacher_type "
+                   "FROM teachers WHERE teacher_id=" + to_string(id);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return nullopt;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    optional<Teacher> teacher;
+    if (MYSQL_ROW row = mysql_fetch_row(result)) {
+        teacher.emplace();
+        teacher->id = toInt(row[0]);
+        teacher->name = row[1] ? row[1] : "";
+        teacher->email = row[2] ? row[2] : "";
+        teacher->salary = toDouble(row[3]);
+        teacher->joinDate = toDate(row[4]);
+        teacher->type = row[5] ? row[5] : "";
+    }
+    mysql_free_result(result);
+    
+    return teacher;
+}
+
+optional<ClassInfo> MySqlDatabase::getTeacherClassAssignment(int teacherId) {
+    if (!ensureConnection()) return nullopt;
+    
+    string query = "SELECT tca.class_id, c.class_name FROM teacher_class_assignments tca "
+                       "JOIN classes c ON tca.class_id = c.class_id "
+                       "WHERE tca.teacher_id=" + to_string(teacherId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return nullopt;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    optional<ClassInfo> assignment;
+    if (MYSQL_ROW row = mysql_fetch_row(result)) {
+        assignment.emplace();
+        assignment->id = toInt(row[0]);
+        assignment->name = row[1] ? row[1] : "";
+    }
+    mysql_free_result(result);
+    
+    return assignment;
+}
+
+vector<Assignment> MySqlDatabase::getTeacherSubjectAssignments(int teacherId) {
+    vector<Assignment> assignments;
+    if (!ensureConnection()) return assignments;
+    
+    string query = "SELECT tsa.subject_id, s.name, tsa.class_id, c.class_name "
+                       "FROM teacher_subject_assignments tsa "
+                       "JOIN subjects s ON tsa.subject_id = s.subject_id "
+                       "JOIN classes c ON tsa.class_id = c.class_id "
+                       "WHERE tsa.teacher_id=" + to_string(teacherId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return assignments;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    assignments.reserve(mysql_num_rows(result));
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        Assignment assignment;
+        assignment.subjectId = toInt(row[0]);
+        assignment.subjectName = row[1] ? row[1] : "";
+        assignment.classId = toInt(row[2]);
+        assignment.className = row[3] ? row[3] : "";
+        assignments.push_back(move(assignment));
+    }
+    
+    mysql_free_result(result);
+    return assignments;
+}
+
+unordered_map<int, vector<Assignment>> MySqlDatabase::getAllTeacherSubjectAssignments() {
+    unordered_map<int, vector<Assignment>> assignments;
+    if (!ensureConnection()) return assignments;
+    
+    if (mysql_query(conn, "SELECT tsa.teacher_id, tsa.subject_id, s.name, tsa.class_id, c.class_name "
+                          "FROM teacher_subject_assignments tsa "
+                          "JOIN subjects s ON tsa.subject_id = s.subject_id "
+                          "JOIN classes c ON tsa.class_id = c.class_id")) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return assignments;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        Assignment assignment;
+        assignment.subjectId = toInt(row[1]);
+        assignment.subjectName = row[2] ? row[2] : "";
+        assignment.classId = toInt(row[3]);
+        assignment.className = row[4] ? row[4] : "";
+        assignments[toInt(row[0])].push_back(move(assignment));
+    }
+    
+    mysql_free_result(result);
+    return assignments;
+}
+
+bool MySqlDatabase::assignClassTeacher(int classId, int teacherId) {
+    string query = "INSERT INTO teacher_class_assignments (class_id, teacher_id) VALUES (" + 
+                       to_string(classId) + ", " + to_string(teacherId) + ") "
+                       "ON DUPLICATE KEY UPDATE teacher_id=" + to_string(teacherId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Assignment failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    return true;
+}
+
+bool MySqlDatabase::assignSubjectTeacher(int teacherId, int subjectId, int classId) {
+    string query = "INSERT INTO teacher_subject_assignments (teacher_id, subject_id, class_id) "
+                       "VALUES (" + to_string(teacherId) + ", " + to_string(subjectId) + 
+                       ", " + to_string(classId) + ")";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Assignment failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    return true;
+}
+
+// CRUD - Students
+int MySqlDatabase::createStudent(const string& name, int classId) {
+    if (!ensureConnection()) return -1;
+    
+    string query = "INSERT INTO students (name, class_id) VALUES ('" + 
+                       escapeString(name) + "', " + (classId > 0 ? to_string(classId) : "NULL") + ")";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Insert failed: " << mysql_error(conn) << endl;
+        return -1;
+    }
+    
+    return mysql_insert_id(conn);
+}
+
+vector<Student> MySqlDatabase::getAllStudents() {
+    vector<Student> students;
+    if (!ensureConnection()) return students;
+    
+    string query = string("SELECT s.student_id, s.name, s.class_id, c.class_name ") +
+                       "FROM students s LEFT JOIN classes c ON s.class_id = c.class_id";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return students;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    students.reserve(mysql_num_rows(result));
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        Student student;
+        student.id = toInt(row[0]);
+        student.name = row[1] ? row[1] : "";
+        student.classId = toInt(row[2]);
+        student.className = row[3] ? row[3] : "N/A";
+        students.push_back(move(student));
+    }
+    
+    mysql_free_result(result);
+    return students;
+}
+
+vector<Student> MySqlDatabase::getStudentsPage(int afterId, int limit) {
+    vector<Student> students;
+    if (!ensureConnection()) return students;
+    
+    // Seeks on the primary key, so every page costs the same however deep it is
+    static const char* sql = "SELECT s.student_id, s.name, s.class_id, c.class_name "
+                             "FROM students s LEFT JOIN classes c ON s.class_id = c.class_id "
+                             "WHERE s.student_id > ? "
+                             "ORDER BY s.student_id LIMIT ?";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    MYSQL_BIND params[] = { intParam(afterId), intParam(limit) };
+    IntColumn studentId, classId;
+    TextColumn name{1}, className{3};
+    MYSQL_BIND results[] = { studentId.bind(), name.bind(), classId.bind(), className.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return students;
+    }
+    
+    students.reserve(mysql_stmt_num_rows(stmt));
+    while (fetchRow(stmt)) {
+        Student student;
+        student.id = studentId.get();
+        student.name = name.str(stmt);
+        student.classId = classId.get();
+        student.className = className.str(stmt);
+        students.push_back(move(student));
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return students;
+}
+
+int MySqlDatabase::countStudents() {
+    if (!ensureConnection()) return -1;
+    
+    if (mysql_query(conn, "SELECT COUNT(*) FROM students")) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return -1;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    int count = -1;
+    if (MYSQL_ROW row = mysql_fetch_row(result)) {
+        count = toInt(row[0]);
+    }
+    mysql_free_result(result);
+    
+    return count;
+}
+
+optional<Student> MySqlDatabase::getStudentById(int id) {
+    if (!ensureConnection()) return nullopt;
+    
+    static const char* sql = "SELECT s.student_id, s.name, s.class_id, c.class_name "
+                             "FROM students s LEFT JOIN classes c ON s.class_id = c.class_id "
+                             "WHERE s.student_id=?";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    MYSQL_BIND params[] = { intParam(id) };
+    IntColumn studentId, classId;
+    TextColumn name{1}, className{3};
+    MYSQL_BIND results[] = { studentId.bind(), name.bind(), classId.bind(), className.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return nullopt;
+    }
+    
+    optional<Student> student;
+    if (fetchRow(stmt)) {
+        student.emplace();
+        student->id = studentId.get();
+        student->name = name.str(stmt);
+        student->classId = classId.get();
+        student->className = className.str(stmt, "N/A");
+    }
+    mysql_stmt_free_result(stmt);
+    
+    return student;
+}
+
+vector<Student> MySqlDatabase::getStudentsByClass(int classId) {
+    vector<Student> students;
+    if (!ensureConnection()) return students;
+    
+    static const char* sql = "SELECT student_id, name, class_id FROM students WHERE class_id=?";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    MYSQL_BIND params[] = { intParam(classId) };
+    IntColumn studentId, studentClassId;
+    TextColumn name{1};
+    MYSQL_BIND results[] = { studentId.bind(), name.bind(), studentClassId.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return students;
+    }
+    
+    students.reserve(mysql_stmt_num_rows(stmt));
+    while (fetchRow(stmt)) {
+        Student student;
+        student.id = studentId.get();
+        student.name = name.str(stmt);
+        student.classId = studentClassId.get();
+        students.push_back(move(student));
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return students;
+}
+
+// Attendance operations
+bool MySqlDatabase::markAttendance(int studentId, int subjectId, int classId, 
+                             const Date& date, const string& status) {
+    if (!date.isValid() || !ensureConnection()) return false;
+    
+    static const char* sql = "INSERT INTO attendance_records "
+                             "(student_id, subject_id, class_id, attendance_date, status) "
+                             "VALUES (?, ?, ?, ?, ?)";
+    
+    DateParam dateValue(date);
+    MYSQL_BIND params[] = {
+        intParam(studentId), intParam(subjectId), intParam(classId),
+        dateValue.bind(), stringParam(status)
+    };
+    
+    if (!beginTransaction()) return false;
+    
+    if (!executeStatement(prepareStatement(sql), params, nullptr) ||
+        !bumpAttendanceSummary(studentId, subjectId,
+                               parseAttendanceStatus(status) == AttendanceStatus::Present)) {
+        rollbackTransaction();
+        return false;
+    }
+    
+    return commitTransaction();
+}
+
+MarkAttendanceResult MySqlDatabase::markAttendanceChecked(int studentId, int subjectId,
+                                                    const Date& date, const string& status) {
+    if (!date.isValid() || !ensureConnection()) return MarkAttendanceResult::Failed;
+    
+    // The join only yields a row when the student exists, has a class and the
+    // subject is taught in that class; the unique key rejects duplicates.
+    static const char* sql = "INSERT INTO attendance_records "
+                             "(student_id, subject_id, class_id, attendance_date, status) "
+                             "SELECT s.student_id, cs.subject_id, s.class_id, ?, ? "
+                             "FROM students s "
+                             "JOIN class_subjects cs ON cs.class_id = s.class_id AND cs.subject_id = ? "
+                             "WHERE s.student_id = ?";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    if (stmt == nullptr) return MarkAttendanceResult::Failed;
+    
+    DateParam dateValue(date);
+    MYSQL_BIND params[] = {
+        dateValue.bind(), stringParam(status), intParam(subjectId), intParam(studentId)
+    };
+    
+    if (!beginTransaction()) return MarkAttendanceResult::Failed;
+    
+    if (!executeStatement(stmt, params, nullptr)) {
+        bool duplicate = mysql_stmt_errno(stmt) == ER_DUP_ENTRY;
+        rollbackTransaction();
+        return duplicate ? MarkAttendanceResult::AlreadyMarked : MarkAttendanceResult::Failed;
+    }
+    
+    if (mysql_stmt_affected_rows(stmt) == 1) {
+        if (!bumpAttendanceSummary(studentId, subjectId,
+                                   parseAttendanceStatus(status) == AttendanceStatus::Present)) {
+            rollbackTransaction();
+            return MarkAttendanceResult::Failed;
+        }
+        return commitTransaction() ? MarkAttendanceResult::Marked : MarkAttendanceResult::Failed;
+    }
+    
+    rollbackTransaction();
+    
+    // Nothing inserted: work out which precondition failed
+    auto student = getStudentById(studentId);
+    if (!student) return MarkAttendanceResult::StudentNotFound;
+    if (student->classId == 0) return MarkAttendanceResult::StudentHasNoClass;
+    return MarkAttendanceResult::SubjectNotInClass;
+}
+
+vector<MarkAttendanceResult> MySqlDatabase::markAttendanceBulk(int subjectId, const Date& date,
+                                                         const vector<AttendanceMark>& marks,
+                                                         int classId) {
+    vector<AttendanceEntry> entries;
+    entries.reserve(marks.size());
+    for (const auto& mark : marks) {
+        entries.push_back({mark.studentId, subjectId, date, mark.status, classId});
+    }
+    return markAttendanceBatch(entries);
+}
+
+vector<MarkAttendanceResult> MySqlDatabase::markAttendanceBatch(const vector<AttendanceEntry>& entries) {
+    vector<MarkAttendanceResult> results(entries.size(), MarkAttendanceResult::Failed);
+    if (entries.empty() || !ensureConnection()) return results;
+    
+    if (markAttendanceBatchWithRetry(entries, results) == 0) return results;
+    
+    // The multi-row insert still failed (a duplicate that raced in, a
+    // status too long for its column, ...): retry the marks that passed
+    // validation as one-entry batches, so one bad mark cannot fail the
+    // others and each keeps its class restriction
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (results[i] != MarkAttendanceResult::Marked) continue;
+        vector<MarkAttendanceResult> single(1, MarkAttendanceResult::Failed);
+        unsigned error = markAttendanceBatchWithRetry({entries[i]}, single);
+        if (error == 0) {
+            results[i] = single[0];
+        } else {
+            results[i] = error == ER_DUP_ENTRY ? MarkAttendanceResult::AlreadyMarked : MarkAttendanceResult::Failed;
+        }
+    }
+    return results;
+}
+
+unsigned MySqlDatabase::markAttendanceBatchWithRetry(const vector<AttendanceEntry>& entries,
+                                                     vector<MarkAttendanceResult>& results) {
+    // Marks from unrelated requests share the transaction, so a deadlock or
+    // lock wait is retried rather than failing all of them
+    const int maxAttempts = 3;
+    unsigned error = 0;
+    for (int attempt = 1; attempt <= maxAttempts; ++attempt) {
+        fill(results.begin(), results.end(), MarkAttendanceResult::Failed);
+        error = tryMarkAttendanceBatch(entries, results);
+        if (error != ER_LOCK_DEADLOCK && error != ER_LOCK_WAIT_TIMEOUT) break;
+        this_thread::sleep_for(chrono::milliseconds(5 * attempt));
+    }
+    return error;
+}
+
+unsigned MySqlDatabase::tryMarkAttendanceBatch(const vector<AttendanceEntry>& entries,
+                                               vector<MarkAttendanceResult>& results) {
+    // Distinct student ids, and (student, subject, date) keys for the duplicate check.
+    // Entries without a valid date stay Failed and are left out.
+    unordered_set<int> studentIds;
+    string idList, keyList;
+    for (const auto& entry : entries) {
+        if (!entry.date.isValid()) continue;
+        if (studentIds.insert(entry.studentId).second) {
+            if (!idList.empty()) idList += ',';
+            idList += to_string(entry.studentId);
+        }
+        if (!keyList.empty()) keyList += ',';
+        keyList += "(" + to_string(entry.studentId) + "," + to_string(entry.subjectId) + ",'" +
+                   entry.date.toString() + "')";
+    }
+    if (idList.empty()) return 0;
+    
+    if (!beginTransaction()) return mysql_errno(conn);
+    
+    // Each student's class and every subject taught in it, in one query
+    string query = "SELECT s.student_id, s.class_id, cs.subject_id "
+                   "FROM students s "
+                   "LEFT JOIN class_subjects cs ON cs.class_id = s.class_id "
+                   "WHERE s.student_id IN (" + idList + ")";
+    
+    if (mysql_query(conn, query.c_str())) {
+        unsigned error = mysql_errno(conn);
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        rollbackTransaction();
+        return error;
+    }
+    
+    unordered_map<int, int> studentClass;           // student id -> class id (0 if none)
+    set<pair<int, int>> studentSubjects;            // (student id, subject id) taught in their class
+    MYSQL_RES* result = mysql_store_result(conn);
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        int studentId = toInt(row[0]);
+        studentClass[studentId] = toInt(row[1]);
+        if (row[2]) studentSubjects.insert({studentId, toInt(row[2])});
+    }
+    mysql_free_result(result);
+    
+    // Existing marks. A plain consistent read takes no gap locks; a mark
+    // committed after it is caught by the unique key on the insert.
+    query = "SELECT student_id, subject_id, attendance_date FROM attendance_records "
+            "WHERE (student_id, subject_id, attendance_date) IN (" + keyList + ")";
+    
+    if (mysql_query(conn, query.c_str())) {
+        unsigned error = mysql_errno(conn);
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        rollbackTransaction();
+        return error;
+    }
+    
+    set<tuple<int, int, int32_t>> alreadyMarked;
+    result = mysql_store_result(conn);
+    while ((row = mysql_fetch_row(result))) {
+        alreadyMarked.insert({toInt(row[0]), toInt(row[1]), toDate(row[2]).daysSinceEpoch()});
+    }
+    mysql_free_result(result);
+    
+    string insert = "INSERT INTO attendance_records "
+                    "(student_id, subject_id, class_id, attendance_date, status) VALUES ";
+    // Repeated (student, subject) pairs are applied row by row, so each adds one mark
+    string summary = "INSERT INTO attendance_summary (student_id, subject_id, total, present) VALUES ";
+    size_t rowCount = 0;
+    
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i];
+        auto it = studentClass.find(entry.studentId);
+        
+        if (!entry.date.isValid()) {
+            continue;
+        } else if (it == studentClass.end()) {
+            results[i] = MarkAttendanceResult::StudentNotFound;
+        } else if (it->second == 0) {
+            results[i] = MarkAttendanceResult::StudentHasNoClass;
+        } else if (entry.classId != 0 && it->second != entry.classId) {
+            results[i] = MarkAttendanceResult::StudentNotInClass;
+        } else if (!studentSubjects.count({entry.studentId, entry.subjectId})) {
+            results[i] = MarkAttendanceResult::SubjectNotInClass;
+        } else if (!alreadyMarked.insert({entry.studentId, entry.subjectId, entry.date.daysSinceEpoch()}).second) {
+            // Also catches the same mark listed twice in one batch
+            results[i] = MarkAttendanceResult::AlreadyMarked;
+        } else {
+            if (rowCount++ > 0) {
+                insert += ',';
+                summary += ',';
+            }
+            insert += "(" + to_string(entry.studentId) + "," + to_string(entry.subjectId) + "," +
+                      to_string(it->second) + ",'" + entry.date.toString() + "','" +
+                      escapeString(entry.status) + "')";
+            bool present = parseAttendanceStatus(entry.status) == AttendanceStatus::Present;
+            summary += "(" + to_string(entry.studentId) + "," + to_string(entry.subjectId) + ",1," +
+                       (present ? "1" : "0") + ")";
+            results[i] = MarkAttendanceResult::Marked;
+        }
+    }
+    summary += " ON DUPLICATE KEY UPDATE total = total + 1, present = present + VALUES(present)";
+    
+    if (rowCount > 0 && (mysql_query(conn, insert.c_str()) || mysql_query(conn, summary.c_str()))) {
+        unsigned error = mysql_errno(conn);
+        cerr << "Insert failed: " << mysql_error(conn) << endl;
+        rollbackTransaction();
+        return error;
+    }
+    
+    if (mysql_commit(conn)) {
+        unsigned error = mysql_errno(conn);
+        cerr << "Commit failed: " << mysql_error(conn) << endl;
+        rollbackTransaction();
+        return error;
+    }
+    return 0;
+}
+
+vector<AttendanceRecord> MySqlDatabase::getStudentAttendance(int studentId) {
+    vector<AttendanceRecord> records;
+    forEachStudentAttendance(studentId, [&records](const AttendanceRecord& record) {
+        records.push_back(record);
+        return true;
+    });
+    return records;
+}
+
+vector<AttendanceRecord> MySqlDatabase::getRecentAttendance(int studentId, int limit) {
+    vector<AttendanceRecord> records;
+    if (!ensureConnection()) return records;
+    
+    static const char* sql = "SELECT ar.attendance_date, s.name as subject_name, ar.status, ar.subject_id "
+                             "FROM attendance_records ar "
+                             "JOIN subjects s ON ar.subject_id = s.subject_id "
+                             "WHERE ar.student_id=? "
+                             "ORDER BY ar.attendance_date DESC, ar.attendance_id DESC LIMIT ?";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    MYSQL_BIND params[] = { intParam(studentId), intParam(limit) };
+    DateColumn date;
+    TextColumn subjectName{1}, status{2};
+    IntColumn subjectId;
+    MYSQL_BIND results[] = { date.bind(), subjectName.bind(), status.bind(), subjectId.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return records;
+    }
+    
+    records.reserve(mysql_stmt_num_rows(stmt));
+    while (fetchRow(stmt)) {
+        AttendanceRecord record;
+        record.studentId = studentId;
+        record.subjectId = subjectId.get();
+        record.date = date.date();
+        record.status = parseAttendanceStatus(status.str(stmt));
+        record.subjectName = subjectName.str(stmt);
+        records.push_back(move(record));
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return records;
+}
+
+bool MySqlDatabase::forEachStudentAttendance(int studentId, const AttendanceVisitor& visitor) {
+    if (!ensureConnection()) return false;
+    
+    static const char* sql = "SELECT ar.attendance_date, s.name as subject_name, ar.status, ar.subject_id "
+                             "FROM attendance_records ar "
+                             "JOIN subjects s ON ar.subject_id = s.subject_id "
+                             "WHERE ar.student_id=? "
+                             "ORDER BY ar.attendance_date";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    MYSQL_BIND params[] = { intParam(studentId) };
+    DateColumn date;
+    TextColumn subjectName{1}, status{2};
+    IntColumn subjectId;
+    MYSQL_BIND results[] = { date.bind(), subjectName.bind(), status.bind(), subjectId.bind() };
+    
+    if (!executeStatement(stmt, params, results, false)) {
+        return false;
+    }
+    
+    AttendanceRecord record;
+    record.studentId = studentId;
+    while (fetchRow(stmt)) {
+        record.subjectId = subjectId.get();
+        record.date = date.date();
+        record.status = parseAttendanceStatus(status.str(stmt));
+        record.subjectName.assign(subjectName.data, min<unsigned long>(subjectName.length, sizeof(subjectName.data)));
+        if (!visitor(record)) break;
+    }
+    
+    // Discards any rows left unread after an early stop
+    mysql_stmt_free_result(stmt);
+    return true;
+}
+
+vector<AttendanceRecord> MySqlDatabase::getClassAttendance(int classId) {
+    vector<AttendanceRecord> records;
+    forEachClassAttendance(classId, [&records](const AttendanceRecord& record) {
+        records.push_back(record);
+        return true;
+    });
+    return records;
+}
+
+bool MySqlDatabase::forEachClassAttendance(int classId, const AttendanceVisitor& visitor) {
+    if (!ensureConnection()) return false;
+    
+    string query = "SELECT ar.attendance_date, ar.student_id, st.name as student_name, "
+                       "ar.subject_id, s.name as subject_name, ar.status "
+                       "FROM attendance_records ar "
+                       "JOIN students st ON ar.student_id = st.student_id "
+                       "JOIN subjects s ON ar.subject_id = s.subject_id "
+                       "WHERE ar.class_id=" + to_string(classId) + 
+                       " ORDER BY ar.attendance_date";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    // Unbuffered: rows are read from the socket one at a time
+    MYSQL_RES* result = mysql_use_result(conn);
+    if (result == nullptr) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    AttendanceRecord record;
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        record.date = toDate(row[0]);
+        record.studentId = toInt(row[1]);
+        record.studentName.assign(row[2] ? row[2] : "");
+        record.subjectId = toInt(row[3]);
+        record.subjectName.assign(row[4] ? row[4] : "");
+        record.status = parseAttendanceStatus(row[5] ? row[5] : "");
+        if (!visitor(record)) break;
+    }
+    
+    // Drains any rows left unread after an early stop
+    mysql_free_result(result);
+    return true;
+}
+
+vector<AttendanceRecord> MySqlDatabase::getClassAttendancePage(int classId, const AttendanceRecord& after,
+                                                              int limit) {
+    vector<AttendanceRecord> records;
+    if (!ensureConnection()) return records;
+    
+    // Walks idx_attendance_class_date (class_id, attendance_date, student_id,
+    // subject_id); the unique key makes that triple a total order per class
+    static const char* firstSql = "SELECT ar.attendance_date, ar.student_id, st.name, "
+                                  "ar.subject_id, s.name, ar.status "
+                                  "FROM attendance_records ar "
+                                  "JOIN students st ON ar.student_id = st.student_id "
+                                  "JOIN subjects s ON ar.subject_id = s.subject_id "
+                                  "WHERE ar.class_id = ? "
+                                  "ORDER BY ar.attendance_date, ar.student_id, ar.subject_id LIMIT ?";
+    static const char* nextSql = "SELECT ar.attendance_date, ar.student_id, st.name, "
+                                 "ar.subject_id, s.name, ar.status "
+                                 "FROM attendance_records ar "
+                                 "JOIN students st ON ar.student_id = st.student_id "
+                                 "JOIN subjects s ON ar.subject_id = s.subject_id "
+                                 "WHERE ar.class_id = ? "
+                                 "AND (ar.attendance_date, ar.student_id, ar.subject_id) > (?, ?, ?) "
+                                 "ORDER BY ar.attendance_date, ar.student_id, ar.subject_id LIMIT ?";
+    
+    bool first = !after.date.isValid();
+    MYSQL_STMT* stmt = prepareStatement(first ? firstSql : nextSql);
+    DateParam afterDate(after.date);
+    MYSQL_BIND firstParams[] = { intParam(classId), intParam(limit) };
+    MYSQL_BIND nextParams[] = {
+        intParam(classId), afterDate.bind(), intParam(after.studentId), intParam(after.subjectId),
+        intParam(limit)
+    };
+    DateColumn date;
+    IntColumn studentId, subjectId;
+    TextColumn studentName{2}, subjectName{4}, status{5};
+    MYSQL_BIND results[] = {
+        date.bind(), studentId.bind(), studentName.bind(),
+        subjectId.bind(), subjectName.bind(), status.bind()
+    };
+    
+    if (!executeStatement(stmt, first ? firstParams : nextParams, results)) {
+        return records;
+    }
+    
+    records.reserve(mysql_stmt_num_rows(stmt));
+    while (fetchRow(stmt)) {
+        AttendanceRecord record;
+        record.date = date.date();
+        record.studentId = studentId.get();
+        record.studentName = studentName.str(stmt);
+        record.subjectId = subjectId.get();
+        record.subjectName = subjectName.str(stmt);
+        record.status = parseAttendanceStatus(status.str(stmt));
+        records.push_back(move(record));
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return records;
+}
+
+double MySqlDatabase::getAttendancePercentage(int studentId, int subjectId) {
+    if (!ensureConnection()) return 0.0;
+    
+    // Primary key lookup on attendance_summary; the overall figure sums the
+    // student's per-subject rows, which share the key prefix
+    static const char* subjectSql = "SELECT total, present FROM attendance_summary "
+                                    "WHERE student_id=? AND subject_id=?";
+    static const char* overallSql = "SELECT COALESCE(SUM(total), 0), COALESCE(SUM(present), 0) "
+                                    "FROM attendance_summary WHERE student_id=?";
+    
+    MYSQL_STMT* stmt = prepareStatement(subjectId > 0 ? subjectSql : overallSql);
+    MYSQL_BIND params[] = { intParam(studentId), intParam(subjectId) };
+    IntColumn total, present;
+    MYSQL_BIND results[] = { total.bind(), present.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return 0.0;
+    }
+    
+    AttendanceSummary summary;
+    if (fetchRow(stmt)) {
+        summary.total = total.get();
+        summary.present = present.get();
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return summary.percentage();
+}
+
+vector<AttendanceSummary> MySqlDatabase::getAttendanceSummary(int studentId) {
+    vector<AttendanceSummary> summaries;
+    if (!ensureConnection()) return summaries;
+    
+    static const char* sql = "SELECT sm.subject_id, s.name, sm.total, sm.present "
+                             "FROM attendance_summary sm "
+                             "JOIN subjects s ON sm.subject_id = s.subject_id "
+                             "WHERE sm.student_id=? AND sm.total > 0 "
+                             "ORDER BY s.name";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    MYSQL_BIND params[] = { intParam(studentId) };
+    IntColumn subjectId, total, present;
+    TextColumn name{1};
+    MYSQL_BIND results[] = { subjectId.bind(), name.bind(), total.bind(), present.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return summaries;
+    }
+    
+    summaries.reserve(mysql_stmt_num_rows(stmt));
+    while (fetchRow(stmt)) {
+        AttendanceSummary summary;
+        summary.studentId = studentId;
+        summary.subjectId = subjectId.get();
+        summary.subjectName = name.str(stmt);
+        summary.total = total.get();
+        summary.present = present.get();
+        summaries.push_back(move(summary));
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return summaries;
+}
+
+bool MySqlDatabase::rebuildAttendanceSummary() {
+    if (!ensureConnection()) return false;
+    
+    if (!beginTransaction()) return false;
+    
+    // DELETE rather than TRUNCATE: TRUNCATE commits implicitly
+    if (mysql_query(conn, "DELETE FROM attendance_summary") ||
+        mysql_query(conn, "INSERT INTO attendance_summary (student_id, subject_id, total, present) "
+                          "SELECT student_id, subject_id, COUNT(*), "
+                          "SUM(CASE WHEN status='Present' THEN 1 ELSE 0 END) "
+                          "FROM attendance_records GROUP BY student_id, subject_id")) {
+        cerr << "Summary rebuild failed: " << mysql_error(conn) << endl;
+        rollbackTransaction();
+        return false;
+    }
+    
+    return commitTransaction();
+}
+
+vector<SessionSheetEntry> MySqlDatabase::getClassSessionSheet(int classId, int subjectId, const Date& date) {
+    vector<SessionSheetEntry> sheet;
+    if (!ensureConnection()) return sheet;
+    
+    static const char* sql = "SELECT s.student_id, s.name, ar.status "
+                             "FROM students s "
+                             "LEFT JOIN attendance_records ar ON ar.student_id = s.student_id "
+                             "AND ar.subject_id=? AND ar.attendance_date=? "
+                             "WHERE s.class_id=? "
+                             "ORDER BY s.student_id";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    DateParam dateValue(date);
+    MYSQL_BIND params[] = { intParam(subjectId), dateValue.bind(), intParam(classId) };
+    IntColumn studentId;
+    TextColumn name{1}, status{2};
+    MYSQL_BIND results[] = { studentId.bind(), name.bind(), status.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return sheet;
+    }
+    
+    sheet.reserve(mysql_stmt_num_rows(stmt));
+    while (fetchRow(stmt)) {
+        SessionSheetEntry entry;
+        entry.studentId = studentId.get();
+        entry.studentName = name.str(stmt);
+        entry.marked = !status.isNull;
+        if (entry.marked) {
+            entry.status = parseAttendanceStatus(status.str(stmt));
+        }
+        sheet.push_back(move(entry));
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return sheet;
+}
+
+bool MySqlDatabase::addSubjectToClass(int classId, int subjectId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "INSERT INTO class_subjects (class_id, subject_id) VALUES (" + 
+                       to_string(classId) + ", " + to_string(subjectId) + ")";
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Insert failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    return true;
+}
+
+vector<Subject> MySqlDatabase::getClassSubjects(int classId) {
+    vector<Subject> subjects;
+    if (!ensureConnection()) return subjects;
+    
+    static const char* sql = "SELECT s.subject_id, s.name, s.max_marks "
+                             "FROM class_subjects cs "
+                             "JOIN subjects s ON cs.subject_id = s.subject_id "
+                             "WHERE cs.class_id=?";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    MYSQL_BIND params[] = { intParam(classId) };
+    IntColumn subjectId, maxMarks;
+    TextColumn name{1};
+    MYSQL_BIND results[] = { subjectId.bind(), name.bind(), maxMarks.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return subjects;
+    }
+    
+    subjects.reserve(mysql_stmt_num_rows(stmt));
+    while (fetchRow(stmt)) {
+        Subject subject;
+        subject.id = subjectId.get();
+        subject.name = name.str(stmt);
+        subject.maxMarks = maxMarks.get();
+        subjects.push_back(move(subject));
+    }
+    
+    mysql_stmt_free_result(stmt);
+    return subjects;
+}
+
+unordered_map<int, vector<Subject>> MySqlDatabase::getAllClassSubjects() {
+    unordered_map<int, vector<Subject>> classSubjects;
+    if (!ensureConnection()) return classSubjects;
+    
+    if (mysql_query(conn, "SELECT cs.class_id, s.subject_id, s.name, s.max_marks "
+                          "FROM class_subjects cs "
+                          "JOIN subjects s ON cs.subject_id = s.subject_id")) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return classSubjects;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    MYSQL_ROW row;
+    
+    while ((row = mysql_fetch_row(result))) {
+        Subject subject;
+        subject.id = toInt(row[1]);
+        subject.name = row[2] ? row[2] : "";
+        subject.maxMarks = toInt(row[3]);
+        classSubjects[toInt(row[0])].push_back(move(subject));
+    }
+    
+    mysql_free_result(result);
+    return classSubjects;
+}
+
+// Delete operations
+bool MySqlDatabase::deleteSubject(int subjectId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "DELETE FROM subjects WHERE subject_id=" + to_string(subjectId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Delete failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    return true;
+}
+
+bool MySqlDatabase::deleteClass(int classId) {
+    if (!ensureConnection()) return false;
+    
+    // The class's attendance records cascade away but its students survive,
+    // so take those marks off their summary rows in the same transaction.
+    // Student and subject deletes cascade into attendance_summary directly.
+    string adjust = "UPDATE attendance_summary sm JOIN ("
+                    "SELECT student_id, subject_id, COUNT(*) AS total, "
+                    "SUM(CASE WHEN status='Present' THEN 1 ELSE 0 END) AS present "
+                    "FROM attendance_records WHERE class_id=" + to_string(classId) +
+                    " GROUP BY student_id, subject_id) gone "
+                    "ON sm.student_id = gone.student_id AND sm.subject_id = gone.subject_id "
+                    "SET sm.total = sm.total - gone.total, sm.present = sm.present - gone.present";
+    string query = "DELETE FROM classes WHERE class_id=" + to_string(classId);
+    
+    if (!beginTransaction()) return false;
+    
+    if (mysql_query(conn, adjust.c_str()) || mysql_query(conn, query.c_str())) {
+        cerr << "Delete failed: " << mysql_error(conn) << endl;
+        rollbackTransaction();
+        return false;
+    }
+    
+    return commitTransaction();
+}
+
+bool MySqlDatabase::deleteTeacher(int teacherId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "DELETE FROM teachers WHERE teacher_id=" + to_string(teacherId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Delete failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    return true;
+}
+
+bool MySqlDatabase::deleteStudent(int studentId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "DELETE FROM students WHERE student_id=" + to_string(studentId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Delete failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    return true;
+}
+
+bool MySqlDatabase::updateStudentName(int studentId, const string& newName) {
+    if (!ensureConnection()) return false;
+    
+    string query = "UPDATE students SET name='" + escapeString(newName) + 
+                   "' WHERE student_id=" + to_string(studentId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        cerr << "Update failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    return true;
+}
+
+// Validation operations
+bool MySqlDatabase::classExists(int classId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "SELECT class_id FROM classes WHERE class_id=" + to_string(classId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        return false;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool exists = (mysql_num_rows(result) > 0);
+    mysql_free_result(result);
+    
+    return exists;
+}
+
+bool MySqlDatabase::subjectExists(int subjectId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "SELECT subject_id FROM subjects WHERE subject_id=" + to_string(subjectId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        return false;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool exists = (mysql_num_rows(result) > 0);
+    mysql_free_result(result);
+    
+    return exists;
+}
+
+bool MySqlDatabase::teacherExists(int teacherId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "SELECT teacher_id FROM teachers WHERE teacher_id=" + to_string(teacherId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        return false;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool exists = (mysql_num_rows(result) > 0);
+    mysql_free_result(result);
+    
+    return exists;
+}
+
+bool MySqlDatabase::studentExists(int studentId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "SELECT student_id FROM students WHERE student_id=" + to_string(studentId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        return false;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool exists = (mysql_num_rows(result) > 0);
+    mysql_free_result(result);
+    
+    return exists;
+}
+
+bool MySqlDatabase::isClassNameUnique(const string& className) {
+    if (!ensureConnection()) return true;
+    
+    string query = "SELECT class_id FROM classes WHERE class_name='" + escapeString(className) + "'";
+    
+    if (mysql_query(conn, query.c_str())) {
+        return true;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool unique = (mysql_num_rows(result) == 0);
+    mysql_free_result(result);
+    
+    return unique;
+}
+
+bool MySqlDatabase::isSubjectNameUnique(const string& subjectName) {
+    if (!ensureConnection()) return true;
+    
+    string query = "SELECT subject_id FROM subjects WHERE name='" + escapeString(subjectName) + "'";
+    
+    if (mysql_query(conn, query.c_str())) {
+        return true;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool unique = (mysql_num_rows(result) == 0);
+    mysql_free_result(result);
+    
+    return unique;
+}
+
+bool MySqlDatabase::isAttendanceMarked(int studentId, int subjectId, const Date& date) {
+    if (!date.isValid() || !ensureConnection()) return false;
+    
+    static const char* sql = "SELECT attendance_id FROM attendance_records "
+                             "WHERE student_id=? AND subject_id=? AND attendance_date=?";
+    
+    MYSQL_STMT* stmt = prepareStatement(sql);
+    DateParam dateValue(date);
+    MYSQL_BIND params[] = { intParam(studentId), intParam(subjectId), dateValue.bind() };
+    IntColumn attendanceId;
+    MYSQL_BIND results[] = { attendanceId.bind() };
+    
+    if (!executeStatement(stmt, params, results)) {
+        return false;
+    }
+    
+    bool marked = fetchRow(stmt);
+    mysql_stmt_free_result(stmt);
+    
+    return marked;
+}
+
+bool MySqlDatabase::isSubjectInClass(int subjectId, int classId) {
+    if (!ensureConnection()) return false;
+    
+    string query = "SELECT id FROM class_subjects WHERE class_id=" + to_string(classId) + 
+                   " AND subject_id=" + to_string(subjectId);
+    
+    if (mysql_query(conn, query.c_str())) {
+        return false;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    bool exists = (mysql_num_rows(result) > 0);
+    mysql_free_result(result);
+    
+    return exists;
+}
+
+// Schema maintenance
+bool MySqlDatabase::executeSql(const string& sql) {
+    if (!ensureConnection()) return false;
+    
+    if (mysql_query(conn, sql.c_str())) {
+        cerr << "Statement failed: " << mysql_error(conn) << endl;
+        return false;
+    }
+    
+    // Discard any result set so the connection is ready for the next query
+    if (MYSQL_RES* result = mysql_store_result(conn)) {
+        mysql_free_result(result);
+    }
+    
+    return true;
+}
+
+int MySqlDatabase::getSchemaVersion() {
+    if (!executeSql("CREATE TABLE IF NOT EXISTS schema_migrations ("
+                    "version INT PRIMARY KEY, "
+                    "description VARCHAR(255) NOT NULL, "
+                    "applied_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP)")) {
+        return -1;
+    }
+    
+    if (mysql_query(conn, "SELECT COALESCE(MAX(version), 0) FROM schema_migrations")) {
+        cerr << "Query failed: " << mysql_error(conn) << endl;
+        return -1;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    int version = -1;
+    if (MYSQL_ROW row = mysql_fetch_row(result)) {
+        version = toInt(row[0]);
+    }
+    mysql_free_result(result);
+    
+    return version;
+}
+
+bool MySqlDatabase::recordMigration(int version, const string& description) {
+    return executeSql("INSERT INTO schema_migrations (version, description) VALUES (" +
+                      to_string(version) + ", '" + escapeString(description) + "')");
+}
+
+vector<map<string, string>> MySqlDatabase::explainQuery(const string& query) {
+    vector<map<string, string>> plan;
+    if (!ensureConnection()) return plan;
+    
+    string explain = "EXPLAIN " + query;
+    if (mysql_query(conn, explain.c_str())) {
+        cerr << "Explain failed: " << mysql_error(conn) << endl;
+        return plan;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(conn);
+    unsigned int fieldCount = mysql_num_fields(result);
+    MYSQL_FIELD* fields = mysql_fetch_fields(result);
+    MYSQL_ROW row;
+    
+    // EXPLAIN's columns differ between server versions, so keep them by name
+    while ((row = mysql_fetch_row(result))) {
+        map<string, string> step;
+        for (unsigned int i = 0; i < fieldCount; ++i) {
+            step[fields[i].name] = row[i] ? row[i] : "";
+        }
+        plan.push_back(step);
+    }
+    
+    mysql_free_result(result);
+    return plan;
+}
@@ -0,0 +1,76 @@
+#include "ReferenceCache.h"
+#include <iostream>
+
+using namespace std;
+
+const Subject* ReferenceSnapshot::findSubject(int id) const {
+    auto it = subjectIndex.find(id);
+    return it != subjectIndex.end() ? &subjects[it->second] : nullptr;
+}
+
+const ClassInfo* ReferenceSnapshot::findClass(int id) const {
+    auto it = classIndex.find(id);
+    return it != classIndex.end() ? &classes[it->second] : nullptr;
+}
+
+const vector<Subject>& ReferenceSnapshot::subjectsForClass(int classId) const {
+    static const vector<Subject> none;
+    auto it = classSubjects.find(classId);
+    return it != classSubjects.end() ? it->second : none;
+}
+
+ReferenceCache::ReferenceCache(ConnectionPool& pool) : pool(pool) {}
+
+shared_ptr<const ReferenceSnapshot> ReferenceCache::snapshot() {
+    auto snap = atomic_load(&current);
+    if (!snap) {
+        if (refresh()) snap = atomic_load(&current);
+    } else if (stale.load(memory_order_acquire)) {
+        // One reader retries; the rest keep serving the old snapshot
+        unique_lock<mutex> lock(refreshMutex, try_to_lock);
+        if (lock.owns_lock() && reload()) snap = atomic_load(&current);
+    }
+    return snap;
+}
+
+bool ReferenceCache::refresh() {
+    lock_guard<mutex> lock(refreshMutex);
+    return reload();
+}
+
+bool ReferenceCache::reload() {
+    // Until this succeeds the published snapshot may predate a write
+    stale.store(true, memory_order_release);
+
+    auto lease = pool.acquire();
+    if (!lease) {
+        cerr << "Reference cache refresh failed: no database connection" << endl;
+        return false;
+    }
+
+    // An empty table and a failed query look alike; publishing the latter
+    // would serve empty lists until the next write, so keep the old snapshot
+    auto snap = make_shared<ReferenceSnapshot>();
+    snap->subjects = lease->getAllSubjects();
+    if (!lease->lastQueryFailed()) snap->classes = lease->getAllClasses();
+    if (!lease->lastQueryFailed()) snap->teachers = lease->getAllTeachersWithDetails();
+    if (!lease->lastQueryFailed()) snap->classSubjects = lease->getAllClassSubjects();
+    bool failed = lease->lastQueryFailed();
+    lease.release();
+    if (failed) {
+        cerr << "Reference cache refresh failed: query error, keeping the previous snapshot" << endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < snap->subjects.size(); ++i) {
+        snap->subjectIndex[snap->subjects[i].id] = i;
+    }
+    for (size_t i = 0; i < snap->classes.size(); ++i) {
+        snap->classIndex[snap->classes[i].id] = i;
+    }
+
+    snap->generation = ++generations;
+    atomic_store(&current, shared_ptr<const ReferenceSnapshot>(move(snap)));
+    stale.store(false, memory_order_release);
+    return true;
+}
@@ -0,0 +1,42 @@
+#include "RequestCoalescer.h"
+
+using namespace std;
+
+RequestCoalescer::Result RequestCoalescer::run(const string& key, const function<Response()>& produce, bool& joined) {
+    promise<Result> leader;
+    unique_lock<mutex> guard(lock);
+    auto it = flights.find(key);
+    if (it != flights.end()) {
+        shared_future<Result> flight = it->second;
+        guard.unlock();
+        joined = true;
+        // get() rethrows the leader's exception
+        return flight.get();
+    }
+    flights.emplace(key, leader.get_future().share());
+    guard.unlock();
+
+    joined = false;
+    Result result;
+    try {
+        result = make_shared<const Response>(produce());
+    } catch (...) {
+        guard.lock();
+        flights.erase(key);
+        guard.unlock();
+        leader.set_exception(current_exception());
+        throw;
+    }
+
+    // Callers from here on start a fresh flight
+    guard.lock();
+    flights.erase(key);
+    guard.unlock();
+    leader.set_value(result);
+    return result;
+}
+
+size_t RequestCoalescer::inFlight() const {
+    lock_guard<mutex> guard(lock);
+    return flights.size();
+}
@@ -0,0 +1,210 @@
+#include "SessionTokens.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+using namespace std;
+
+namespace {
+
+// SHA-256 (FIPS 180-4)
+const uint32_t roundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t initialHash[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+void compress(uint32_t h[8], const uint8_t block[64]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+               (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t t1 = k + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) +
+                      roundConstants[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+// Hashes `data` on top of a state that has already absorbed `prefixLength`
+// bytes (a multiple of 64) and writes the 32-byte digest
+void finish(uint32_t h[8], const uint8_t* data, size_t length, uint64_t prefixLength, uint8_t digest[32]) {
+    uint64_t totalBits = (prefixLength + length) * 8;
+
+    while (length >= 64) {
+        compress(h, data);
+        data += 64;
+        length -= 64;
+    }
+
+    uint8_t block[128] = {0};
+    memcpy(block, data, length);
+    block[length] = 0x80;
+    size_t padded = length < 56 ? 64 : 128;
+    for (int i = 0; i < 8; ++i) {
+        block[padded - 1 - i] = static_cast<uint8_t>(totalBits >> (8 * i));
+    }
+    compress(h, block);
+    if (padded == 128) compress(h, block + 64);
+
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(h[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(h[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(h[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(h[i]);
+    }
+}
+
+string base64Url(const uint8_t* data, size_t length) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    string out;
+    out.reserve((length * 4 + 2) / 3);
+
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t chunk = uint32_t(data[i]) << 16;
+        if (i + 1 < length) chunk |= uint32_t(data[i + 1]) << 8;
+        if (i + 2 < length) chunk |= data[i + 2];
+
+        out += alphabet[(chunk >> 18) & 63];
+        out += alphabet[(chunk >> 12) & 63];
+        if (i + 1 < length) out += alphabet[(chunk >> 6) & 63];
+        if (i + 2 < length) out += alphabet[chunk & 63];
+    }
+    return out;
+}
+
+// Compares in time independent of where the strings differ
+bool constantTimeEquals(const string& a, const string& b) {
+    if (a.size() != b.size()) return false;
+    unsigned char diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+// Strict decimal field: digits only, no sign or spaces
+bool parseNumber(const string& text, int64_t& value) {
+    if (text.empty() || text.size() > 18) return false;
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+const char* toString(Role role) {
+    switch (role) {
+        case Role::Admin: return "admin";
+        case Role::Teacher: return "teacher";
+        default: return "student";
+    }
+}
+
+SessionTokens::SessionTokens(const string& secret, chrono::seconds ttl) : ttl(ttl) {
+    // HMAC key block: keys longer than a block are hashed first
+    uint8_t key[64] = {0};
+    if (secret.size() > sizeof(key)) {
+        uint32_t h[8];
+        memcpy(h, initialHash, sizeof(h));
+        finish(h, reinterpret_cast<const uint8_t*>(secret.data()), secret.size(), 0, key);
+    } else {
+        memcpy(key, secret.data(), secret.size());
+    }
+
+    uint8_t pad[64];
+    for (int i = 0; i < 64; ++i) pad[i] = key[i] ^ 0x36;
+    memcpy(innerPad.h, initialHash, sizeof(innerPad.h));
+    compress(innerPad.h, pad);
+
+    for (int i = 0; i < 64; ++i) pad[i] = key[i] ^ 0x5c;
+    memcpy(outerPad.h, initialHash, sizeof(outerPad.h));
+    compress(outerPad.h, pad);
+}
+
+string SessionTokens::sign(const string& message) const {
+    HashState inner = innerPad;
+    HashState outer = outerPad;
+    uint8_t innerDigest[32];
+    uint8_t mac[32];
+
+    finish(inner.h, reinterpret_cast<const uint8_t*>(message.data()), message.size(), 64, innerDigest);
+    finish(outer.h, innerDigest, sizeof(innerDigest), 64, mac);
+    return base64Url(mac, sizeof(mac));
+}
+
+string SessionTokens::issue(Role role, int id) const {
+    int64_t expiresAt = static_cast<int64_t>(time(nullptr)) + ttl.count();
+    string body = string(toString(role)) + "." + to_string(id) + "." + to_string(expiresAt);
+    return body + "." + sign(body);
+}
+
+optional<Session> SessionTokens::verify(const string& token) const {
+    size_t signatureStart = token.rfind('.');
+    if (signatureStart == string::npos) return nullopt;
+
+    string body = token.substr(0, signatureStart);
+    if (!constantTimeEquals(token.substr(signatureStart + 1), sign(body))) return nullopt;
+
+    // Signed, so the body is one we issued: role.id.expiry
+    size_t first = body.find('.');
+    size_t second = body.find('.', first + 1);
+    if (first == string::npos || second == string::npos) return nullopt;
+
+    Session session;
+    string role = body.substr(0, first);
+    if (role == "admin") {
+        session.role = Role::Admin;
+    } else if (role == "teacher") {
+        session.role = Role::Teacher;
+    } else if (role == "student") {
+        session.role = Role::Student;
+    } else {
+        return nullopt;
+    }
+
+    int64_t id = 0;
+    if (!parseNumber(body.substr(first + 1, second - first - 1), id) ||
+        !parseNumber(body.substr(second + 1), session.expiresAt)) {
+        return nullopt;
+    }
+    session.id = static_cast<int>(id);
+
+    if (session.expiresAt <= static_cast<int64_t>(time(nullptr))) return nullopt;
+    return session;
+}
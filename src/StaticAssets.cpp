@@ -0,0 +1,119 @@
+#include "StaticAssets.h"
+#include "HttpCompression.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+uint64_t fnv1a(const string& data) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+string hexHash(const string& data) {
+    char text[20];
+    snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(fnv1a(data)));
+    return text;
+}
+
+const char* contentTypeFor(const string& extension) {
+    static const unordered_map<string, const char*> types = {
+        {".html", "text/html"},
+        {".css", "text/css"},
+        {".js", "application/javascript"},
+        {".json", "application/json"},
+        {".svg", "image/svg+xml"},
+        {".txt", "text/plain"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".ico", "image/x-icon"},
+        {".woff2", "font/woff2"}
+    };
+    auto it = types.find(extension);
+    return it != types.end() ? it->second : "application/octet-stream";
+}
+
+void replaceAll(string& text, const string& from, const string& to) {
+    for (size_t pos = text.find(from); pos != string::npos; pos = text.find(from, pos + to.size())) {
+        text.replace(pos, from.size(), to);
+    }
+}
+
+} // namespace
+
+size_t StaticAssets::load(const string& root, size_t maxFileBytes) {
+    assets.clear();
+    error_code ec;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->file_size(ec) > maxFileBytes) continue;
+
+        ifstream in(it->path(), ios::binary);
+        if (!in) {
+            cerr << "Static assets: cannot read " << it->path() << endl;
+            continue;
+        }
+        StaticAsset asset;
+        asset.body.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        asset.contentType = contentTypeFor(it->path().extension().string());
+        asset.version = hexHash(asset.body).substr(0, 10);
+
+        string url = "/" + fs::relative(it->path(), root, ec).generic_string();
+        assets[url] = move(asset);
+    }
+
+    // Pages last: their tags and compressed forms cover the rewritten text
+    for (auto& entry : assets) {
+        StaticAsset& asset = entry.second;
+        if (asset.contentType == "text/html") versionReferences(asset);
+
+        asset.etag = "\"" + hexHash(asset.body) + "\"";
+        if (isCompressibleType(asset.contentType) &&
+            compressBody(asset.body.data(), asset.body.size(), ContentEncoding::Gzip, 9, asset.gzipped) &&
+            asset.gzipped.size() >= asset.body.size() * 9 / 10) {
+            asset.gzipped.clear();
+        }
+    }
+    return assets.size();
+}
+
+void StaticAssets::versionReferences(StaticAsset& page) const {
+    // Pages live at the root, so they refer to "css/style.css" or "/css/style.css"
+    for (const auto& entry : assets) {
+        if (entry.second.contentType == "text/html") continue;
+        const string& url = entry.first;
+        string versioned = "?v=" + entry.second.version + "\"";
+        replaceAll(page.body, "\"" + url.substr(1) + "\"", "\"" + url.substr(1) + versioned);
+        replaceAll(page.body, "\"" + url + "\"", "\"" + url + versioned);
+    }
+}
+
+const StaticAsset* StaticAssets::find(const string& path) const {
+    auto it = assets.find(!path.empty() && path.back() == '/' ? path + "index.html" : path);
+    return it != assets.end() ? &it->second : nullptr;
+}
+
+size_t StaticAssets::totalBytes() const {
+    size_t total = 0;
+    for (const auto& entry : assets) total += entry.second.body.size();
+    return total;
+}
+
+size_t StaticAssets::totalGzippedBytes() const {
+    size_t total = 0;
+    for (const auto& entry : assets) {
+        total += entry.second.gzipped.empty() ? entry.second.body.size() : entry.second.gzipped.size();
+    }
+    return total;
+}
@@ -23,9 +23,9 @@ void StudentController::viewMyAttendance() {
         UIHelper::printSeparator(60);
         
         for (const auto& record : records) {
-            cout << left << setw(15) << record.at("date")
-                      << setw(30) << record.at("subject")
-                      << setw(15) << record.at("status") << endl;
+            cout << left << setw(15) << record.date.toString()
+                      << setw(30) << record.subjectName
+                      << setw(15) << toString(record.status) << endl;
         }
     }
     
@@ -42,25 +42,20 @@ void StudentController::viewAttendancePercentage() {
     cout << "Overall Attendance: " << fixed << setprecision(2) 
               << overallPercentage << "%" << endl;
     
-    // Get all subjects for subject-wise percentage
-    auto subjects = db->getAllSubjects();
+    // One read of the student's summary rows instead of a query per subject
+    auto summaries = db->getAttendanceSummary(studentId);
     
-    if (!subjects.empty()) {
+    if (!summaries.empty()) {
         cout << "\nSubject-wise Attendance:" << endl;
         UIHelper::printSeparator(50);
         cout << left << setw(30) << "Subject" 
                   << setw(20) << "Percentage" << endl;
         UIHelper::printSeparator(50);
         
-        for (const auto& subject : subjects) {
-            int subjectId = stoi(subject.at("subject_id"));
-            double percentage = db->getAttendancePercentage(studentId, subjectId);
-            
-            if (percentage > 0) {  // Only show subjects with attendance records
-                cout << left << setw(30) << subject.at("name")
-                          << setw(20) << (to_string(static_cast<int>(percentage)) + "%") 
-                          << endl;
-            }
+        for (const auto& summary : summaries) {
+            cout << left << setw(30) << summary.subjectName
+                      << setw(20) << (to_string(static_cast<int>(summary.percentage())) + "%") 
+                      << endl;
         }
     }
     
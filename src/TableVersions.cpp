@@ -0,0 +1,59 @@
+#include "TableVersions.h"
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+
+using namespace std;
+
+TableVersions::TableVersions() {
+    for (auto& version : versions) {
+        version.store(0, memory_order_relaxed);
+    }
+    random_device rd;
+    char text[20];
+    snprintf(text, sizeof(text), "%08x", static_cast<unsigned>(rd()));
+    prefix = text;
+}
+
+void TableVersions::bump(unsigned tables) {
+    for (int i = 0; i < tableCount; ++i) {
+        if (tables & (1u << i)) versions[i].fetch_add(1, memory_order_release);
+    }
+}
+
+string TableVersions::etag(unsigned tables, uint64_t extra) const {
+    string tag = "\"" + prefix;
+    for (int i = 0; i < tableCount; ++i) {
+        if (tables & (1u << i)) {
+            tag += '.' + to_string(versions[i].load(memory_order_acquire));
+        }
+    }
+    if (extra != 0) tag += '-' + to_string(extra);
+    tag += '"';
+    return tag;
+}
+
+unsigned TableVersions::writtenBy(const string& method) {
+    // Deletes cascade through foreign keys, so they invalidate everything
+    static const unordered_map<string, unsigned> writes = {
+        {"createSubject", Tables::Subjects},
+        {"createClass", Tables::Classes},
+        {"createTeacher", Tables::Teachers},
+        {"assignClassTeacher", Tables::Teachers | Tables::Classes},
+        {"assignSubjectTeacher", Tables::TeacherSubjects},
+        {"createStudent", Tables::Students},
+        {"updateStudentName", Tables::Students},
+        {"addSubjectToClass", Tables::ClassSubjects},
+        {"deleteSubject", Tables::All},
+        {"deleteClass", Tables::All},
+        {"deleteTeacher", Tables::All},
+        {"deleteStudent", Tables::All},
+        {"markAttendance", Tables::Attendance},
+        {"markAttendanceChecked", Tables::Attendance},
+        {"markAttendanceBulk", Tables::Attendance},
+        {"markAttendanceBatch", Tables::Attendance},
+        {"rebuildAttendanceSummary", Tables::Attendance}
+    };
+    auto it = writes.find(method);
+    return it != writes.end() ? it->second : 0;
+}
@@ -0,0 +1,97 @@
+#include "TeacherAssignmentIndex.h"
+#include <mutex>
+
+using namespace std;
+
+void TeacherAssignmentIndex::load(Database& db) {
+    unordered_map<int, unordered_set<uint64_t>> subjects;
+    unordered_map<int, int> classes;
+    unordered_map<int, string> names;
+    auto lists = db.getAllTeacherSubjectAssignments();
+
+    for (const auto& teacher : lists) {
+        auto& pairs = subjects[teacher.first];
+        for (const auto& assignment : teacher.second) {
+            pairs.insert(key(assignment.subjectId, assignment.classId));
+        }
+    }
+    // One row per class a teacher is class teacher of
+    for (const auto& teacher : db.getAllTeachersWithDetails()) {
+        if (teacher.classId > 0) {
+            classes[teacher.classId] = teacher.id;
+            names[teacher.classId] = teacher.className;
+        }
+    }
+
+    unique_lock<shared_mutex> write(lock);
+    subjectClasses = move(subjects);
+    teacherSubjects = move(lists);
+    classTeachers = move(classes);
+    classNames = move(names);
+}
+
+void TeacherAssignmentIndex::assignClassTeacher(const ClassInfo& cls, int teacherId) {
+    unique_lock<shared_mutex> write(lock);
+    classTeachers[cls.id] = teacherId;
+    classNames[cls.id] = cls.name;
+}
+
+void TeacherAssignmentIndex::assignSubjectTeacher(int teacherId, const Assignment& assignment) {
+    unique_lock<shared_mutex> write(lock);
+    if (subjectClasses[teacherId].insert(key(assignment.subjectId, assignment.classId)).second) {
+        teacherSubjects[teacherId].push_back(assignment);
+    }
+}
+
+bool TeacherAssignmentIndex::canMark(int teacherId, int subjectId, int classId) const {
+    shared_lock<shared_mutex> read(lock);
+    auto it = subjectClasses.find(teacherId);
+    return it != subjectClasses.end() && it->second.count(key(subjectId, classId)) > 0;
+}
+
+bool TeacherAssignmentIndex::teachesClass(int teacherId, int classId) const {
+    shared_lock<shared_mutex> read(lock);
+    auto classTeacher = classTeachers.find(classId);
+    if (classTeacher != classTeachers.end() && classTeacher->second == teacherId) return true;
+
+    auto it = subjectClasses.find(teacherId);
+    if (it == subjectClasses.end()) return false;
+    for (uint64_t pair : it->second) {
+        if (static_cast<int>(uint32_t(pair)) == classId) return true;
+    }
+    return false;
+}
+
+int TeacherAssignmentIndex::classTeacherOf(int classId) const {
+    shared_lock<shared_mutex> read(lock);
+    auto it = classTeachers.find(classId);
+    return it != classTeachers.end() ? it->second : 0;
+}
+
+optional<ClassInfo> TeacherAssignmentIndex::classOf(int teacherId) const {
+    shared_lock<shared_mutex> read(lock);
+    optional<ClassInfo> cls;
+    for (const auto& entry : classTeachers) {
+        if (entry.second != teacherId || (cls && cls->id < entry.first)) continue;
+        cls.emplace();
+        cls->id = entry.first;
+        auto name = classNames.find(entry.first);
+        if (name != classNames.end()) cls->name = name->second;
+    }
+    return cls;
+}
+
+vector<Assignment> TeacherAssignmentIndex::assignmentsOf(int teacherId) const {
+    shared_lock<shared_mutex> read(lock);
+    auto it = teacherSubjects.find(teacherId);
+    return it != teacherSubjects.end() ? it->second : vector<Assignment>();
+}
+
+size_t TeacherAssignmentIndex::assignmentCount() const {
+    shared_lock<shared_mutex> read(lock);
+    size_t count = classTeachers.size();
+    for (const auto& teacher : subjectClasses) {
+        count += teacher.second.size();
+    }
+    return count;
+}
@@ -5,8 +5,9 @@
 
 using namespace std;
 
-TeacherController::TeacherController(Database* db, int id, const string& name, const string& type)
-    : BaseController(db), teacherId(id), teacherName(name), teacherType(type) {}
+TeacherController::TeacherController(Database* db, const TeacherAssignmentIndex& assignments,
+                                     int id, const string& name, const string& type)
+    : BaseController(db), assignments(assignments), teacherId(id), teacherName(name), teacherType(type) {}
 
 void TeacherController::markAttendance() {
     UIHelper::clearScreen();
@@ -14,23 +15,23 @@ void TeacherController::markAttendance() {
     
     if (teacherType == "ClassTeacher") {
         // Get teacher's assigned class
-        auto assignment = db->getTeacherClassAssignment(teacherId);
-        if (assignment.empty()) {
+        auto assignment = assignments.classOf(teacherId);
+        if (!assignment) {
             cout << "You are not assigned to any class." << endl;
             UIHelper::pause();
             return;
         }
         
-        int classId = stoi(assignment["class_id"]);
-        cout << "Your Class: " << assignment["class_name"] << endl;
+        int classId = assignment->id;
+        cout << "Your Class: " << assignment->name << endl;
         
         // Get subjects that this teacher is assigned to teach (as SubjectTeacher) in their class
-        auto teacherSubjects = db->getTeacherSubjectAssignments(teacherId);
+        auto teacherSubjects = assignments.assignmentsOf(teacherId);
         
         // Filter to only subjects in this specific class
-        vector<map<string, string>> assignedSubjects;
+        vector<Assignment> assignedSubjects;
         for (const auto& subj : teacherSubjects) {
-            if (stoi(subj.at("class_id")) == classId) {
+            if (subj.classId == classId) {
                 assignedSubjects.push_back(subj);
             }
         }
@@ -53,43 +54,33 @@ void TeacherController::markAttendance() {
         cout << "\nYour Assigned Subjects:" << endl;
         UIHelper::printSeparator(40);
         for (const auto& subject : assignedSubjects) {
-            cout << "ID: " << subject.at("subject_id") << " - " << subject.at("subject_name") << endl;
+            cout << "ID: " << subject.subjectId << " - " << subject.subjectName << endl;
         }
         UIHelper::printSeparator(40);
         
         int subjectId = getIntInput("\nEnter subject ID: ");
         
         // Validate teacher is assigned to this subject
-        bool isAssigned = false;
-        for (const auto& subj : assignedSubjects) {
-            if (stoi(subj.at("subject_id")) == subjectId) {
-                isAssigned = true;
-                break;
-            }
-        }
-        
-        if (!isAssigned) {
+        if (!assignments.canMark(teacherId, subjectId, classId)) {
             cout << "\nError: You are not assigned to teach this subject!" << endl;
             UIHelper::pause();
             return;
         }
         
-        string date = getDate("Enter attendance date:");
+        Date date = getDate("Enter attendance date:");
         
         cout << "\nStudents in class:" << endl;
         UIHelper::printSeparator(60);
         
         for (const auto& student : students) {
-            cout << "\nStudent: " << student.at("name") << " (ID: " << student.at("student_id") << ")" << endl;
+            cout << "\nStudent: " << student.name << " (ID: " << student.id << ")" << endl;
             cout << "Mark as (1-Present / 2-Absent): ";
             int statusChoice;
             cin >> statusChoice;
             clearInputBuffer();
             
             string status = (statusChoice == 1) ? "Present" : "Absent";
-            int studentId = stoi(student.at("student_id"));
-            
-            if (db->markAttendance(studentId, subjectId, classId, date, status)) {
+            if (db->markAttendance(student.id, subjectId, classId, date, status)) {
                 cout << "Marked " << status << endl;
             } else {
                 cout << "Failed to mark attendance (may already be marked)" << endl;
@@ -98,8 +89,8 @@ void TeacherController::markAttendance() {
         
     } else if (teacherType == "SubjectTeacher") {
         // Get teacher's subject-class assignments
-        auto assignments = db->getTeacherSubjectAssignments(teacherId);
-        if (assignments.empty()) {
+        auto teacherSubjects = assignments.assignmentsOf(teacherId);
+        if (teacherSubjects.empty()) {
             cout << "You are not assigned to any subject-class combination." << endl;
             UIHelper::pause();
             return;
@@ -107,22 +98,29 @@ void TeacherController::markAttendance() {
         
         cout << "Your Assignments:" << endl;
         UIHelper::printSeparator(60);
-        for (size_t i = 0; i < assignments.size(); ++i) {
-            cout << (i + 1) << ". " << assignments[i].at("subject_name") 
-                      << " - " << assignments[i].at("class_name") << endl;
+        for (size_t i = 0; i < teacherSubjects.size(); ++i) {
+            cout << (i + 1) << ". " << teacherSubjects[i].subjectName 
+                      << " - " << teacherSubjects[i].className << endl;
         }
         UIHelper::printSeparator(60);
         
         int choice = getIntInput("\nSelect assignment (number): ");
-        if (choice < 1 || choice > static_cast<int>(assignments.size())) {
+        if (choice < 1 || choice > static_cast<int>(teacherSubjects.size())) {
             cout << "Invalid choice." << endl;
             UIHelper::pause();
             return;
         }
         
-        auto selectedAssignment = assignments[choice - 1];
-        int subjectId = stoi(selectedAssignment["subject_id"]);
-        int classId = stoi(selectedAssignment["class_id"]);
+        const auto& selectedAssignment = teacherSubjects[choice - 1];
+        int subjectId = selectedAssignment.subjectId;
+        int classId = selectedAssignment.classId;
+        
+        // The index may have changed since the list was taken
+        if (!assignments.canMark(teacherId, subjectId, classId)) {
+            cout << "\nError: You are not assigned to teach this subject!" << endl;
+            UIHelper::pause();
+            return;
+        }
         
         // Get students in this class
         auto students = db->getStudentsByClass(classId);
@@ -132,22 +130,20 @@ void TeacherController::markAttendance() {
             return;
         }
         
-        string date = getDate("Enter attendance date:");
+        Date date = getDate("Enter attendance date:");
         
         cout << "\nStudents in class:" << endl;
         UIHelper::printSeparator(60);
         
         for (const auto& student : students) {
-            cout << "\nStudent: " << student.at("name") << " (ID: " << student.at("student_id") << ")" << endl;
+            cout << "\nStudent: " << student.name << " (ID: " << student.id << ")" << endl;
             cout << "Mark as (1-Present / 2-Absent): ";
             int statusChoice;
             cin >> statusChoice;
             clearInputBuffer();
             
             string status = (statusChoice == 1) ? "Present" : "Absent";
-            int studentId = stoi(student.at("student_id"));
-            
-            if (db->markAttendance(studentId, subjectId, classId, date, status)) {
+            if (db->markAttendance(student.id, subjectId, classId, date, status)) {
                 cout << "Marked " << status << endl;
             } else {
                 cout << "Failed to mark attendance (may already be marked)" << endl;
@@ -176,9 +172,9 @@ void TeacherController::viewStudentAttendance() {
         UIHelper::printSeparator(60);
         
         for (const auto& record : records) {
-            cout << left << setw(15) << record.at("date")
-                      << setw(30) << record.at("subject")
-                      << setw(15) << record.at("status") << endl;
+            cout << left << setw(15) << record.date.toString()
+                      << setw(30) << record.subjectName
+                      << setw(15) << toString(record.status) << endl;
         }
     }
     
@@ -192,17 +188,17 @@ void TeacherController::viewClassAttendance() {
     int classId;
     
     if (teacherType == "ClassTeacher") {
-        auto assignment = db->getTeacherClassAssignment(teacherId);
-        if (assignment.empty()) {
+        auto assignment = assignments.classOf(teacherId);
+        if (!assignment) {
             cout << "You are not assigned to any class." << endl;
             UIHelper::pause();
             return;
         }
-        classId = stoi(assignment["class_id"]);
-        cout << "Viewing attendance for: " << assignment["class_name"] << endl;
+        classId = assignment->id;
+        cout << "Viewing attendance for: " << assignment->name << endl;
     } else {
-        auto assignments = db->getTeacherSubjectAssignments(teacherId);
-        if (assignments.empty()) {
+        auto teacherSubjects = assignments.assignmentsOf(teacherId);
+        if (teacherSubjects.empty()) {
             cout << "You are not assigned to any class." << endl;
             UIHelper::pause();
             return;
@@ -210,38 +206,40 @@ void TeacherController::viewClassAttendance() {
         
         cout << "Your Classes:" << endl;
         UIHelper::printSeparator(40);
-        for (size_t i = 0; i < assignments.size(); ++i) {
-            cout << (i + 1) << ". " << assignments[i].at("class_name") << endl;
+        for (size_t i = 0; i < teacherSubjects.size(); ++i) {
+            cout << (i + 1) << ". " << teacherSubjects[i].className << endl;
         }
         UIHelper::printSeparator(40);
         
         int choice = getIntInput("\nSelect class (number): ");
-        if (choice < 1 || choice > static_cast<int>(assignments.size())) {
+        if (choice < 1 || choice > static_cast<int>(teacherSubjects.size())) {
             cout << "Invalid choice." << endl;
             UIHelper::pause();
             return;
         }
         
-        classId = stoi(assignments[choice - 1]["class_id"]);
+        classId = teacherSubjects[choice - 1].classId;
     }
     
-    auto records = db->getClassAttendance(classId);
+    // Stream rows straight to the terminal; a whole term can be large
+    size_t count = 0;
+    db->forEachClassAttendance(classId, [&count](const AttendanceRecord& record) {
+        if (count++ == 0) {
+            cout << "\n" << left << setw(15) << "Date" 
+                      << setw(25) << "Student" 
+                      << setw(25) << "Subject"
+                      << setw(15) << "Status" << endl;
+            UIHelper::printSeparator(80);
+        }
+        cout << left << setw(15) << record.date.toString()
+                  << setw(25) << record.studentName
+                  << setw(25) << record.subjectName
+                  << setw(15) << toString(record.status) << '\n';
+        return true;
+    });
     
-    if (records.empty()) {
+    if (count == 0) {
         cout << "\nNo attendance records found for this class." << endl;
-    } else {
-        cout << "\n" << left << setw(15) << "Date" 
-                  << setw(25) << "Student" 
-                  << setw(25) << "Subject"
-                  << setw(15) << "Status" << endl;
-        UIHelper::printSeparator(80);
-        
-        for (const auto& record : records) {
-            cout << left << setw(15) << record.at("date")
-                      << setw(25) << record.at("student")
-                      << setw(25) << record.at("subject")
-                      << setw(15) << record.at("status") << endl;
-        }
     }
     
     UIHelper::pause();
@@ -257,15 +255,15 @@ void TeacherController::addStudentToClass() {
         return;
     }
     
-    auto assignment = db->getTeacherClassAssignment(teacherId);
-    if (assignment.empty()) {
+    auto assignment = assignments.classOf(teacherId);
+    if (!assignment) {
         cout << "You are not assigned to any class." << endl;
         UIHelper::pause();
         return;
     }
     
-    int classId = stoi(assignment["class_id"]);
-    cout << "Adding student to: " << assignment["class_name"] << endl;
+    int classId = assignment->id;
+    cout << "Adding student to: " << assignment->name << endl;
     
     string name = getInput("\nEnter student name: ");
     
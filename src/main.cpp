@@ -1,12 +1,16 @@
 #include "Database.h"
+#include "MySqlDatabase.h"
 #include "Config.h"
 #include "UIHelper.h"
 #include "AdminController.h"
 #include "TeacherController.h"
 #include "StudentController.h"
+#include "Migrations.h"
+#include "TeacherAssignmentIndex.h"
 #include <iostream>
 #include <memory>
 #include <limits>
+#include <cstring>
 
 using namespace std;
 
@@ -41,7 +45,7 @@ int getIntInput(const string& prompt) {
     }
 }
 
-void adminLogin(Database* db) {
+void adminLogin(Database* db, TeacherAssignmentIndex& assignments) {
     UIHelper::clearScreen();
     UIHelper::printHeader("Admin Login");
     
@@ -52,7 +56,7 @@ void adminLogin(Database* db) {
         cout << "\nLogin successful!" << endl;
         UIHelper::pause();
         
-        AdminController adminController(db);
+        AdminController adminController(db, assignments);
         adminController.showMenu();
     } else {
         cout << "\nInvalid credentials!" << endl;
@@ -60,24 +64,20 @@ void adminLogin(Database* db) {
     }
 }
 
-void teacherLogin(Database* db) {
+void teacherLogin(Database* db, const TeacherAssignmentIndex& assignments) {
     UIHelper::clearScreen();
     UIHelper::printHeader("Teacher Login");
     
     string email = getInput("Email: ");
     string password = getInput("Password: ");
     
-    auto teacherData = db->authenticateTeacher(email, password);
+    auto teacher = db->authenticateTeacher(email, password);
     
-    if (!teacherData.empty()) {
+    if (teacher) {
         cout << "\nLogin successful!" << endl;
         UIHelper::pause();
         
-        int teacherId = stoi(teacherData["teacher_id"]);
-        string name = teacherData["name"];
-        string type = teacherData["teacher_type"];
-        
-        TeacherController teacherController(db, teacherId, name, type);
+        TeacherController teacherController(db, assignments, teacher->id, teacher->name, teacher->type);
         teacherController.showMenu();
     } else {
         cout << "\nInvalid credentials!" << endl;
@@ -91,14 +91,14 @@ void studentLogin(Database* db) {
     
     int studentId = getIntInput("Enter your Student ID: ");
     
-    auto studentData = db->getStudentById(studentId);
+    auto student = db->getStudentById(studentId);
     
-    if (!studentData.empty()) {
+    if (student) {
         cout << "\nLogin successful!" << endl;
-        cout << "Welcome, " << studentData["name"] << "!" << endl;
+        cout << "Welcome, " << student->name << "!" << endl;
         UIHelper::pause();
         
-        StudentController studentController(db, studentId, studentData["name"]);
+        StudentController studentController(db, studentId, student->name);
         studentController.showMenu();
     } else {
         cout << "\nStudent not found!" << endl;
@@ -106,7 +106,7 @@ void studentLogin(Database* db) {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     // Load configuration
     auto config = Config::loadConfig("config.txt");
     
@@ -116,16 +116,46 @@ int main() {
         return 1;
     }
     
-    // Connect to database
-    Database db(config);
+    // Connect to database (the "storage" key picks the backend)
+    auto db = Database::create(config);
     
-    if (!db.isConnected()) {
+    if (!db->isConnected()) {
         cerr << "Failed to connect to database!" << endl;
         cerr << "Please check your configuration and ensure MySQL is running." << endl;
         return 1;
     }
     
+    // Maintenance modes: apply schema migrations or verify query plans, then exit
+    auto* mysqlDb = dynamic_cast<MySqlDatabase*>(db.get());
+    if (argc > 1 && (strcmp(argv[1], "--migrate") == 0 || strcmp(argv[1], "--check-plans") == 0)) {
+        if (mysqlDb == nullptr) {
+            cerr << argv[1] << " requires storage=mysql" << endl;
+            return 1;
+        }
+        if (strcmp(argv[1], "--migrate") == 0) {
+            return Migrations::run(*mysqlDb) ? 0 : 1;
+        }
+        return Migrations::checkQueryPlans(*mysqlDb) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--rebuild-summary") == 0) {
+        return db->rebuildAttendanceSummary() ? 0 : 1;
+    }
+    
+    // Marking attendance needs the tables added by migrations, so bring the
+    // schema up to date first unless disabled (auto_migrate=false)
+    if (mysqlDb != nullptr && (!config.count("auto_migrate") || config.at("auto_migrate") != "false")) {
+        if (!Migrations::run(*mysqlDb)) {
+            cerr << "Schema migration failed! Fix the error above, then run: ./attendance_system --migrate" << endl;
+            return 1;
+        }
+    }
+    
     cout << "Database connection successful!" << endl;
+    
+    // Who may mark what, checked in memory when teachers mark attendance
+    TeacherAssignmentIndex assignments;
+    assignments.load(*db);
+    
     UIHelper::pause();
     
     int choice;
@@ -136,13 +166,13 @@ int main() {
         
         switch (choice) {
             case 1:
-                adminLogin(&db);
+                adminLogin(db.get(), assignments);
                 break;
             case 2:
-                teacherLogin(&db);
+                teacherLogin(db.get(), assignments);
                 break;
             case 3:
-                studentLogin(&db);
+                studentLogin(db.get());
                 break;
             case 0:
                 cout << "Thank you for using Attendance Management System!" << endl;
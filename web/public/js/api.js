@@ -72,8 +72,23 @@ class API {
     }
 
     // Students
-    static async getStudents() {
-        return await this.get('/students');
+    // One page of students: { data, total, nextCursor }
+    static async getStudents(limit = 100, cursor = 0) {
+        return await this.get(`/students?limit=${limit}&cursor=${cursor}`);
+    }
+
+    // Every student, fetched page by page (for dropdowns)
+    static async getAllStudents() {
+        const students = [];
+        let cursor = 0;
+        while (true) {
+            const page = await this.getStudents(500, cursor);
+            if (!page.success) return page;
+            students.push(...page.data);
+            if (page.nextCursor == null) break;
+            cursor = page.nextCursor;
+        }
+        return { success: true, data: students };
     }
 
     static async createStudent(name) {
@@ -93,14 +108,24 @@ class API {
     }
 
     // Attendance
-    static async markAttendance(studentId, subjectId, date, status) {
-        return await this.post('/attendance', { studentId, subjectId, date, status });
+    // classId is required for teachers: the class they teach the subject in
+    static async markAttendance(studentId, subjectId, classId, date, status) {
+        return await this.post('/attendance', { studentId, subjectId, classId, date, status });
+    }
+
+    static async markAttendanceBulk(subjectId, classId, date, records) {
+        return await this.post('/attendance/bulk', { subjectId, classId, date, records });
     }
 
     static async getStudentAttendance(studentId, subjectId) {
         return await this.get(`/students/${studentId}/attendance/subject/${subjectId}`);
     }
 
+    // Overall and per-subject counts plus recent records, in one request
+    static async getStudentDashboard(studentId, recent = 10) {
+        return await this.get(`/students/${studentId}/dashboard?recent=${recent}`);
+    }
+
     static async getAttendancePercentage(studentId) {
         return await this.get(`/students/${studentId}/attendance-percentage`);
     }
@@ -117,33 +142,81 @@ class API {
         return await this.get(`/attendance/check?studentId=${studentId}&subjectId=${subjectId}&date=${date}`);
     }
 
+    // Range reports; from/to are YYYY-MM-DD and default to the whole term
+    static async getSchoolAttendanceReport(from = '', to = '') {
+        return await this.get(`/reports/attendance?${this.rangeQuery(from, to)}`);
+    }
+
+    static async getClassAttendanceReport(classId, subjectId, from = '', to = '') {
+        return await this.get(`/classes/${classId}/attendance/report?subjectId=${subjectId}&${this.rangeQuery(from, to)}`);
+    }
+
+    static rangeQuery(from, to) {
+        const params = new URLSearchParams();
+        if (from) params.set('from', from);
+        if (to) params.set('to', to);
+        return params.toString();
+    }
+
     // HTTP Methods
+    // JSON content type plus the session token issued at login, if any
+    static headers() {
+        const headers = { 'Content-Type': 'application/json' };
+        const user = sessionStorage.getItem('user');
+        const token = user ? JSON.parse(user).token : null;
+        if (token) headers['Authorization'] = `Bearer ${token}`;
+        return headers;
+    }
+
+    // GET responses are kept with their ETag for the rest of the session and
+    // revalidated with If-None-Match; a 304 reuses the stored body
     static async get(endpoint) {
         try {
+            const cached = this.cachedResponse(endpoint);
+            const headers = this.headers();
+            if (cached) headers['If-None-Match'] = cached.etag;
             const response = await fetch(API_BASE_URL + endpoint, {
                 method: 'GET',
-                headers: {
-                    'Content-Type': 'application/json'
-                }
+                headers,
+                cache: 'no-store'  // revalidation is handled here, not by the browser cache
             });
+            if (response.status === 401) logout();
+            if (response.status === 304 && cached) return JSON.parse(cached.body);
             const text = await response.text();
             if (!text) return { success: false, error: 'Empty response from server' };
-            return JSON.parse(text);
+            const parsed = JSON.parse(text);
+            // Only successful replies are worth revalidating; an error kept
+            // here would be replayed by every later 304
+            const etag = response.headers.get('ETag');
+            if (etag && response.ok && parsed.success) this.storeResponse(endpoint, etag, text);
+            return parsed;
         } catch (error) {
             console.error('GET request failed:', error);
             return { success: false, error: error.message };
         }
     }
 
+    static cachedResponse(endpoint) {
+        const entry = sessionStorage.getItem('etag:' + endpoint);
+        return entry ? JSON.parse(entry) : null;
+    }
+
+    static storeResponse(endpoint, etag, body) {
+        try {
+            sessionStorage.setItem('etag:' + endpoint, JSON.stringify({ etag, body }));
+        } catch (error) {
+            // Storage full: this response just won't be revalidated
+        }
+    }
+
     static async post(endpoint, data) {
         try {
             const response = await fetch(API_BASE_URL + endpoint, {
                 method: 'POST',
-                headers: {
-                    'Content-Type': 'application/json'
-                },
+                headers: this.headers(),
                 body: JSON.stringify(data)
             });
+            if (response.status === 401) logout();
             const text = await response.text();
             if (!text) return { success: false, error: 'Empty response from server' };
             return JSON.parse(text);
@@ -157,11 +230,10 @@ class API {
         try {
             const response = await fetch(API_BASE_URL + endpoint, {
                 method: 'PUT',
-                headers: {
-                    'Content-Type': 'application/json'
-                },
+                headers: this.headers(),
                 body: JSON.stringify(data)
             });
+            if (response.status === 401) logout();
             const text = await response.text();
             if (!text) return { success: false, error: 'Empty response from server' };
             return JSON.parse(text);
@@ -175,10 +247,9 @@ class API {
         try {
             const response = await fetch(API_BASE_URL + endpoint, {
                 method: 'DELETE',
-                headers: {
-                    'Content-Type': 'application/json'
-                }
+                headers: this.headers()
             });
+            if (response.status === 401) logout();
             const text = await response.text();
             if (!text) return { success: false, error: 'Empty response from server' };
             return JSON.parse(text);
@@ -229,7 +300,7 @@ function showSuccess(elementId, message) {
 }
 
 function logout() {
-    sessionStorage.removeItem('user');
+    sessionStorage.clear();  // the session token and responses cached under it
     window.location.href = 'index.html';
 }
 
@@ -1,28 +1,219 @@
 #include "../../include/Database.h"
+#include "../../include/MySqlDatabase.h"
+#include "../../include/ConnectionPool.h"
+#include "../../include/ReferenceCache.h"
+#include "../../include/AttendanceWriteQueue.h"
+#include "../../include/AttendanceBitmapIndex.h"
+#include "../../include/SessionTokens.h"
+#include "../../include/TeacherAssignmentIndex.h"
+#include "../../include/AccessLog.h"
+#include "../../include/Metrics.h"
+#include "../../include/JsonWriter.h"
+#include "../../include/RequestCoalescer.h"
+#include "../../include/TableVersions.h"
+#include "../../include/HttpCompression.h"
+#include "../../include/StaticAssets.h"
+#include "../../include/Migrations.h"
 #include "../../include/Config.h"
 #include "../include/httplib.h"
 #include "../include/json.hpp"
 #include <iostream>
 #include <string>
 #include <vector>
+#include <unordered_set>
 #include <sstream>
-#include <mutex>
 #include <filesystem>
+#include <stdexcept>
+#include <random>
+#include <cstdio>
+#include <charconv>
 
 using json = nlohmann::json;
 using namespace std;
 
-// Global database instance
-Database* db = nullptr;
-// Mutex to protect database access from multiple threads
-mutex db_mutex;
+// Global connection pool shared by all worker threads
+ConnectionPool* pool = nullptr;
 
-// Thread-safe database call wrapper
+// Subjects, classes, teachers and class subjects, served without a DB round-trip
+ReferenceCache* referenceCache = nullptr;
+
+// Batches single attendance marks into group commits
+AttendanceWriteQueue* writeQueue = nullptr;
+
+// This term's attendance as bitsets, for the report endpoints
+AttendanceBitmapIndex* attendanceIndex = nullptr;
+
+// Signs the bearer tokens handed out at login and checks them on every request
+SessionTokens* sessionTokens = nullptr;
+
+// Which teacher may mark which subject in which class, checked in memory
+TeacherAssignmentIndex* teacherAssignments = nullptr;
+
+// Request log, written by a background thread
+AccessLog* accessLog = nullptr;
+
+// The frontend's files, held in memory with gzipped copies
+StaticAssets* staticAssets = nullptr;
+
+// Smaller response bodies are sent uncompressed (compress_min_bytes)
+size_t compressMinBytes = 1024;
+
+// Per-table change counters behind the ETags on GET responses
+TableVersions* tableVersions = nullptr;
+
+// Shares one execution between identical concurrent reads
+RequestCoalescer* coalescer = nullptr;
+
+// What GET /metrics reports; the families below are registered in main()
+MetricsRegistry* metrics = nullptr;
+HistogramFamily* requestLatency = nullptr;
+HistogramFamily* dbCallLatency = nullptr;
+Histogram* poolWait = nullptr;
+Counter* poolTimeouts = nullptr;
+Counter* coalescedRequests = nullptr;
+
+// Per-request timings. A request runs start to finish on one worker thread,
+// so thread_local state is per request; it is reset once the request is logged.
+struct RequestTiming {
+    chrono::steady_clock::duration queue{};      // accepted until a worker took it
+    chrono::steady_clock::duration lease{};      // waiting for pooled connections
+    chrono::steady_clock::duration db{};         // inside Database calls
+    chrono::steady_clock::duration serialize{};  // json::dump of the response
+    chrono::steady_clock::duration coalesced{};  // waiting on an identical request
+    chrono::steady_clock::duration compress{};   // gzip/deflate of the response
+    chrono::steady_clock::time_point handlerStart{};
+    int dbCalls = 0;
+};
+static thread_local RequestTiming requestTiming;
+
+// Server-Timing header value for the request finishing on this thread, in
+// milliseconds. `app` is handler time outside the database and json::dump,
+// mostly building the JSON; `total` runs from reading the request line.
+static string serverTimingHeader(chrono::steady_clock::duration total) {
+    auto ms = [](chrono::steady_clock::duration d) {
+        return chrono::duration<double, milli>(max(d, chrono::steady_clock::duration::zero())).count();
+    };
+    const RequestTiming& t = requestTiming;
+    chrono::steady_clock::duration app{};
+    if (t.handlerStart != chrono::steady_clock::time_point()) {
+        app = chrono::steady_clock::now() - t.handlerStart - t.lease - t.db - t.serialize - t.coalesced;
+    }
+
+    char header[256];
+    int length = snprintf(header, sizeof(header),
+                          "queue;dur=%.3f, lease;dur=%.3f, db;dur=%.3f;desc=\"%d calls\", app;dur=%.3f, "
+                          "serialize;dur=%.3f, total;dur=%.3f",
+                          ms(t.queue), ms(t.lease), ms(t.db), t.dbCalls, ms(app), ms(t.serialize), ms(total));
+    if (t.coalesced > chrono::steady_clock::duration::zero()) {
+        length += snprintf(header + length, sizeof(header) - length, ", coalesced;dur=%.3f", ms(t.coalesced));
+    }
+    if (t.compress > chrono::steady_clock::duration::zero()) {
+        snprintf(header + length, sizeof(header) - length, ", compress;dur=%.3f", ms(t.compress));
+    }
+    return header;
+}
+
+// Requests accepted but not yet picked up by a worker
+static atomic<size_t> queuedRequests{0};
+
+// httplib's ThreadPool is final, so wrap it to count the queue
+class CountingTaskQueue : public httplib::TaskQueue {
+public:
+    explicit CountingTaskQueue(size_t threads) : workers(threads) {}
+
+    bool enqueue(function<void()> fn) override {
+        queuedRequests.fetch_add(1, memory_order_relaxed);
+        auto enqueued = chrono::steady_clock::now();
+        bool accepted = workers.enqueue([fn = move(fn), enqueued] {
+            queuedRequests.fetch_sub(1, memory_order_relaxed);
+            // A task serves one keep-alive connection; only its first
+            // request waited in the queue
+            requestTiming.queue = chrono::steady_clock::now() - enqueued;
+            fn();
+        });
+        if (!accepted) queuedRequests.fetch_sub(1, memory_order_relaxed);
+        return accepted;
+    }
+    void shutdown() override { workers.shutdown(); }
+    void on_idle() override { workers.on_idle(); }
+
+private:
+    httplib::ThreadPool workers;
+};
+
+// Adds the time until it goes out of scope to the request's database time
+// and to the latency histogram of the Database method being called
+struct DbTimer {
+    Histogram& histogram;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    explicit DbTimer(Histogram& histogram) : histogram(histogram) {}
+    ~DbTimer() {
+        auto elapsed = chrono::steady_clock::now() - start;
+        requestTiming.db += elapsed;
+        requestTiming.dbCalls++;
+        histogram.observe(elapsed);
+    }
+};
+
+// Method name of a DB_CALL: "db->getStudentById(studentId)" -> "getStudentById"
+static string dbMethodName(const string& call) {
+    string method = call.substr(0, call.find('('));
+    if (method.compare(0, 4, "db->") == 0) method.erase(0, 4);
+    return method;
+}
+
+// Bumps the versions of the tables a call wrote once it returns
+struct TableBump {
+    unsigned tables;
+    ~TableBump() {
+        if (tables != 0) tableVersions->bump(tables);
+    }
+};
+
+// Leases a pooled connection, recording the wait; throws on timeout
+static ConnectionPool::Lease acquireConnection() {
+    auto start = chrono::steady_clock::now();
+    auto lease = pool->acquire();
+    auto waited = chrono::steady_clock::now() - start;
+    requestTiming.lease += waited;
+    poolWait->observe(waited);
+    if (!lease) {
+        poolTimeouts->add();
+        throw runtime_error("Database busy, please retry");
+    }
+    return lease;
+}
+
+// Database call wrapper: leases a pooled connection (bound to `db`) for the
+// duration of a single call, timing it for the request log and metrics and
+// bumping the versions of any tables it writes. Each call site resolves its
+// histogram and tables once. Throws if no connection frees up in time.
 #define DB_CALL(call) ({ \
-    lock_guard<mutex> lock(db_mutex); \
+    static Histogram& dbCallSite = dbCallLatency->get(dbMethodName(#call)); \
+    static const unsigned dbCallWrites = TableVersions::writtenBy(dbMethodName(#call)); \
+    TableBump tableBump{dbCallWrites}; \
+    auto lease = acquireConnection(); \
+    DbTimer dbTimer(dbCallSite); \
+    Database* db = lease.get(); \
     call; \
 })
 
+// Current reference snapshot, kept alive for as long as the caller holds
+// it; throws like DB_CALL if it cannot be loaded
+static shared_ptr<const ReferenceSnapshot> referenceData() {
+    auto snap = referenceCache->snapshot();
+    if (!snap) throw runtime_error("Database busy, please retry");
+    return snap;
+}
+
+// Reloads the teacher assignment index after a delete cascaded into it.
+// Outside DB_CALL, whose latency series are named after Database methods.
+static void reloadTeacherAssignments() {
+    auto lease = acquireConnection();
+    teacherAssignments->load(*lease.get());
+}
+
 // Helper to read integer fields that may be sent as strings
 static int getIntField(const json& j, const string& key, int defaultVal = 0) {
     if (!j.contains(key)) return defaultVal;
@@ -35,6 +226,24 @@ static int getIntField(const json& j, const string& key, int defaultVal = 0) {
     return defaultVal;
 }
 
+// Reads an optional YYYY-MM-DD query parameter; false if present but malformed
+static bool getDateParam(const httplib::Request& req, const string& key, Date& date) {
+    date = Date();
+    if (!req.has_param(key)) return true;
+    date = Date::parse(req.get_param_value(key));
+    return date.isValid();
+}
+
+// Reads an integer query parameter. If it is absent, `value` keeps its
+// default unless `required`; false if missing when required or not a number.
+static bool getIntParam(const httplib::Request& req, const string& key, int& value, bool required = false) {
+    if (!req.has_param(key)) return !required;
+    string text = req.get_param_value(key);
+    const char* end = text.data() + text.size();
+    auto parsed = from_chars(text.data(), end, value);
+    return parsed.ec == errc() && parsed.ptr == end;
+}
+
 // Helper function to create error response
 json errorResponse(const string& message) {
     return {{"success", false}, {"error", message}};
@@ -50,29 +259,260 @@ json successResponse(const json& data = json::object()) {
     return response;
 }
 
-// Helper function to convert map vector to json array
-json mapVectorToJson(const vector<map<string, string>>& vec) {
-    json arr = json::array();
-    for (const auto& m : vec) {
-        json obj;
-        for (const auto& pair : m) {
-            // Normalize ID field names to 'id'
-            if (pair.first == "subject_id" || pair.first == "class_id" || 
-                pair.first == "teacher_id" || pair.first == "student_id") {
-                obj["id"] = pair.second;
-            } 
-            // Normalize class_name to name
-            else if (pair.first == "class_name") {
-                obj["name"] = pair.second;
-            } 
-            // Add all other fields as-is
-            else {
-                obj[pair.first] = pair.second;
-            }
-        }
-        arr.push_back(obj);
+// Serializes a JSON response body, timing it for Server-Timing. Error
+// replies drop any ETag set by notModified(), so clients never revalidate
+// against a transient failure.
+static void sendJson(httplib::Response& res, const json& body) {
+    if (body.value("success", true) == false) res.headers.erase("ETag");
+    auto start = chrono::steady_clock::now();
+    string text = body.dump();
+    requestTiming.serialize += chrono::steady_clock::now() - start;
+    res.set_content(move(text), "application/json");
+}
+
+// 400 reply for a query parameter rejected by getIntParam
+static void invalidParam(httplib::Response& res, const string& key) {
+    res.status = 400;
+    sendJson(res, errorResponse("Missing or invalid " + key));
+}
+
+// Buffer for responses written with JsonWriter. It belongs to the worker
+// thread and keeps its capacity between requests, so large lists stop
+// reallocating once it has grown to fit them.
+static string& jsonBuffer() {
+    thread_local string buffer;
+    buffer.clear();
+    return buffer;
+}
+
+// Sends a body written into jsonBuffer(), copying it out once
+static void sendJson(httplib::Response& res, string& buffer) {
+    res.set_content(buffer.data(), buffer.size(), "application/json");
+    // Don't let one huge response pin its memory to the thread forever
+    if (buffer.capacity() > (size_t(4) << 20)) string().swap(buffer);
+}
+
+// Single-flight for the read endpoints that opt in: concurrent requests for
+// the same path and query share one run of `handler` and its serialized
+// body. Call it after the endpoint's authorization checks, which still run
+// for every request; the response must not depend on who asked.
+static void coalesce(const httplib::Request& req, httplib::Response& res,
+                     const function<void(httplib::Response&)>& handler) {
+    string key = req.path;
+    char separator = '?';
+    for (const auto& param : req.params) {   // sorted by name
+        key += separator + param.first + '=' + param.second;
+        separator = '&';
+    }
+    // Only share with a flight that started at the same data version; a
+    // newer tag over an older body would make clients keep stale data
+    if (res.has_header("ETag")) key += '#' + res.get_header_value("ETag");
+
+    auto start = chrono::steady_clock::now();
+    bool joined = false;
+    auto result = coalescer->run(key, [&handler] {
+        httplib::Response out;
+        out.set_header("ETag", "");  // erased by an error reply
+        handler(out);
+        return RequestCoalescer::Response{out.status, out.get_header_value("Content-Type"), move(out.body),
+                                          !out.has_header("ETag")};
+    }, joined);
+
+    if (joined) {
+        coalescedRequests->add();
+        requestTiming.coalesced += chrono::steady_clock::now() - start;
+    }
+    res.status = result->status;
+    res.set_content(result->body, result->contentType);
+    if (result->failed) res.headers.erase("ETag");
+}
+
+// Replaces every value of a response header
+static void replaceHeader(httplib::Response& res, const string& name, const string& value) {
+    res.headers.erase(name);
+    res.set_header(name, value);
+}
+
+// Compresses a finished text or JSON body of at least compressMinBytes for
+// clients that accept gzip or deflate. Runs after httplib has set
+// Content-Length, so that is corrected here too.
+static void compressResponse(const httplib::Request& req, httplib::Response& res) {
+    if (res.status != 200 || res.body.size() < compressMinBytes || res.has_header("Content-Encoding")) return;
+    if (!isCompressibleType(res.get_header_value("Content-Type"))) return;
+
+    res.set_header("Vary", "Accept-Encoding");
+    ContentEncoding encoding = negotiateEncoding(req.get_header_value("Accept-Encoding"));
+    if (encoding == ContentEncoding::Identity) return;
+
+    auto start = chrono::steady_clock::now();
+    string compressed;
+    bool ok = compressBody(res.body.data(), res.body.size(), encoding, 6, compressed);  // zlib's default level
+    requestTiming.compress += chrono::steady_clock::now() - start;
+    if (!ok) return;
+
+    res.body.swap(compressed);
+    res.set_header("Content-Encoding", toString(encoding));
+    replaceHeader(res, "Content-Length", to_string(res.body.size()));
+    if (res.has_header("ETag")) {
+        replaceHeader(res, "ETag", encodedEtag(res.get_header_value("ETag"), encoding));
+    }
+}
+
+// Answers GET/HEAD for a file loaded into staticAssets: the precompressed
+// copy when the client takes gzip, 304 when its cached copy is current.
+// Pages reference the other files with ?v=<hash>, and requests carrying it
+// may be cached for a year; anything else revalidates on every use.
+static bool serveStaticAsset(const httplib::Request& req, httplib::Response& res) {
+    if (req.method != "GET" && req.method != "HEAD") return false;
+    const StaticAsset* asset = staticAssets->find(req.path);
+    if (asset == nullptr) return false;
+
+    bool versioned = req.has_param("v") && req.get_param_value("v") == asset->version;
+    res.set_header("Cache-Control", versioned ? "public, max-age=31536000, immutable" : "no-cache");
+
+    bool gzip = !asset->gzipped.empty() &&
+                negotiateEncoding(req.get_header_value("Accept-Encoding")) == ContentEncoding::Gzip;
+    if (!asset->gzipped.empty()) res.set_header("Vary", "Accept-Encoding");
+    res.set_header("ETag", gzip ? encodedEtag(asset->etag, ContentEncoding::Gzip) : asset->etag);
+
+    if (etagMatches(req.get_header_value("If-None-Match"), asset->etag)) {
+        res.status = 304;
+        return true;
+    }
+
+    // Served straight from the loaded copy, without copying it per request
+    const string& body = gzip ? asset->gzipped : asset->body;
+    if (gzip) res.set_header("Content-Encoding", "gzip");
+    res.status = 200;
+    res.set_content_provider(body.size(), asset->contentType,
+                             [&body](size_t offset, size_t length, httplib::DataSink& sink) {
+                                 return sink.write(body.data() + offset, length);
+                             });
+    return true;
+}
+
+// Conditional GET: tags the response with the versions of the tables it is
+// built from (plus `extra`, e.g. a reference snapshot's generation) and
+// answers 304 Not Modified if the client already holds that version. Call
+// it after authorization and before reading any data, so a write landing in
+// between can only make the body newer than its tag, never older.
+static bool notModified(const httplib::Request& req, httplib::Response& res,
+                        unsigned tables, uint64_t extra = 0) {
+    string etag = tableVersions->etag(tables, extra);
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
+    if (!etagMatches(req.get_header_value("If-None-Match"), etag)) return false;
+    res.status = 304;
+    return true;
+}
+
+// Conditional GET for a response built only from a reference snapshot: its
+// generation is the version. The table counters would move on a write whose
+// snapshot refresh then failed, tagging the old data as new.
+static bool notModified(const httplib::Request& req, httplib::Response& res, const ReferenceSnapshot& snap) {
+    return notModified(req, res, 0, snap.generation);
+}
+
+// Starts {"success":true,"data": ; the caller writes the data value and any
+// other top-level fields, then calls endObject()
+static JsonWriter& beginSuccess(JsonWriter& out) {
+    return out.beginObject().field("success", true).key("data");
+}
+
+static void forbid(httplib::Response& res) {
+    res.status = 403;
+    sendJson(res, errorResponse("Not allowed for this account"));
+}
+
+// Checks the request's "Authorization: Bearer <token>" against the session
+// signature (no database access) and that its role is one of `allowed`.
+// Otherwise answers 401/403 and returns nullopt.
+static optional<Session> authorize(const httplib::Request& req, httplib::Response& res,
+                                   initializer_list<Role> allowed) {
+    const string prefix = "Bearer ";
+    string header = req.get_header_value("Authorization");
+    optional<Session> session;
+    if (header.compare(0, prefix.size(), prefix) == 0) {
+        session = sessionTokens->verify(header.substr(prefix.size()));
+    }
+    if (!session) {
+        res.status = 401;
+        sendJson(res, errorResponse("Not logged in or session expired"));
+        return nullopt;
+    }
+    for (Role role : allowed) {
+        if (role == session->role) return session;
+    }
+    forbid(res);
+    return nullopt;
+}
+
+// Handler prologue: binds `session` to the verified caller or returns early
+#define REQUIRE_ROLE(...) \
+    auto session = authorize(req, res, {__VA_ARGS__}); \
+    if (!session) return
+
+// Students and teachers may only reach their own records through id routes
+static bool ownsRecord(const Session& session, Role role, int id) {
+    return session.role != role || session.id == id;
+}
+
+// Teachers only see classes they are class teacher of or teach a subject in
+static bool mayAccessClass(const Session& session, int classId) {
+    return session.role != Role::Teacher || teacherAssignments->teachesClass(session.id, classId);
+}
+
+// Login payload fields shared by all roles
+static void addSessionToken(json& data, Role role, int id) {
+    data["token"] = sessionTokens->issue(role, id);
+    data["expiresIn"] = sessionTokens->lifetime().count();
+}
+
+// JSON serialisation for Database rows (picked up by nlohmann::json via ADL).
+// Primary keys are always exposed as "id".
+void to_json(json& j, const Subject& subject) {
+    j = {{"id", subject.id}, {"name", subject.name}, {"max_marks", subject.maxMarks}};
+}
+
+void to_json(json& j, const ClassInfo& cls) {
+    j = {{"id", cls.id}, {"name", cls.name}};
+}
+
+// Attendance records only go out in lists, written with JsonWriter
+static void writeRecord(JsonWriter& out, const AttendanceRecord& record) {
+    out.beginObject()
+       .field("date", record.date.toString())
+       .field("subject", record.subjectName)
+       .field("subject_id", record.subjectId)
+       .field("status", toString(record.status))
+       .endObject();
+}
+
+// Quote a CSV field if it contains a separator, quote or newline
+static void appendCsvField(string& out, const string& value) {
+    if (value.find_first_of(",\"\n\r") == string::npos) {
+        out += value;
+        return;
+    }
+    out += '"';
+    for (char c : value) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+// Error message for a rejected attendance mark
+static const char* markResultMessage(MarkAttendanceResult result) {
+    switch (result) {
+        case MarkAttendanceResult::Marked: return "";
+        case MarkAttendanceResult::StudentNotFound: return "Student not found";
+        case MarkAttendanceResult::StudentHasNoClass: return "Student is not assigned to any class";
+        case MarkAttendanceResult::SubjectNotInClass: return "Subject is not assigned to the student's class";
+        case MarkAttendanceResult::StudentNotInClass: return "Student is not in this class";
+        case MarkAttendanceResult::AlreadyMarked: return "Attendance already marked for this student, subject, and date";
+        default: return "Failed to mark attendance";
     }
-    return arr;
 }
 
 // Authentication endpoints
@@ -82,19 +522,21 @@ void setupAuthEndpoints(httplib::Server& svr) {
         try {
             auto body = json::parse(req.body);
             if (!body.contains("email") || !body.contains("password")) {
-                res.set_content(errorResponse("Missing email or password").dump(), "application/json");
+                sendJson(res, errorResponse("Missing email or password"));
                 return;
             }
             string email = body["email"];
             string password = body["password"];
             
             if (DB_CALL(db->authenticateAdmin(email, password))) {
-                res.set_content(successResponse({{"role", "admin"}, {"email", email}}).dump(), "application/json");
+                json data = {{"role", "admin"}, {"email", email}};
+                addSessionToken(data, Role::Admin, 0);
+                sendJson(res, successResponse(data));
             } else {
-                res.set_content(errorResponse("Invalid credentials").dump(), "application/json");
+                sendJson(res, errorResponse("Invalid credentials"));
             }
         } catch (const exception& e) {
-            res.set_content(errorResponse(string("Invalid request: ") + e.what()).dump(), "application/json");
+            sendJson(res, errorResponse(string("Invalid request: ") + e.what()));
         }
     });
 
@@ -103,36 +545,33 @@ void setupAuthEndpoints(httplib::Server& svr) {
         try {
             auto body = json::parse(req.body);
             if (!body.contains("email") || !body.contains("password")) {
-                res.set_content(errorResponse("Missing email or password").dump(), "application/json");
+                sendJson(res, errorResponse("Missing email or password"));
                 return;
             }
             string email = body["email"];
             string password = body["password"];
             
-            auto teacherData = DB_CALL(db->authenticateTeacher(email, password));
-            if (!teacherData.empty() && teacherData.count("id") && teacherData["id"] != "0") {
+            auto teacher = DB_CALL(db->authenticateTeacher(email, password));
+            if (teacher && teacher->id != 0) {
                 json data = {
                     {"role", "teacher"},
-                    {"teacherId", stoi(teacherData["id"])},
-                    {"name", teacherData["name"]},
-                    {"email", teacherData["email"]},
-                    {"type", teacherData["type"]}
+                    {"teacherId", teacher->id},
+                    {"name", teacher->name},
+                    {"email", teacher->email},
+                    {"type", teacher->type}
                 };
                 
                 // Get class assignment if exists
-                auto classAssignment = DB_CALL(db->getTeacherClassAssignment(stoi(teacherData["id"])));
-                if (!classAssignment.empty() && classAssignment.count("class_id")) {
-                    data["classId"] = stoi(classAssignment["class_id"]);
-                } else {
-                    data["classId"] = 0;
-                }
+                auto classAssignment = teacherAssignments->classOf(teacher->id);
+                data["classId"] = classAssignment ? classAssignment->id : 0;
+                addSessionToken(data, Role::Teacher, teacher->id);
                 
-                res.set_content(successResponse(data).dump(), "application/json");
+                sendJson(res, successResponse(data));
             } else {
-                res.set_content(errorResponse("Invalid credentials").dump(), "application/json");
+                sendJson(res, errorResponse("Invalid credentials"));
             }
         } catch (const exception& e) {
-            res.set_content(errorResponse(string("Invalid request: ") + e.what()).dump(), "application/json");
+            sendJson(res, errorResponse(string("Invalid request: ") + e.what()));
         }
     });
 
@@ -142,7 +581,7 @@ void setupAuthEndpoints(httplib::Server& svr) {
             auto body = json::parse(req.body);
             // Frontend sends ID in 'email' field for compatibility with generic login function
             if (!body.contains("email")) {
-                res.set_content(errorResponse("Missing Student ID").dump(), "application/json");
+                sendJson(res, errorResponse("Missing Student ID"));
                 return;
             }
             
@@ -151,35 +590,35 @@ void setupAuthEndpoints(httplib::Server& svr) {
             try {
                 studentId = stoi(idStr);
             } catch (...) {
-                res.set_content(errorResponse("Invalid Student ID format").dump(), "application/json");
+                sendJson(res, errorResponse("Invalid Student ID format"));
                 return;
             }
             
-            auto studentMap = DB_CALL(db->getStudentById(studentId));
+            auto student = DB_CALL(db->getStudentById(studentId));
             
-            if (!studentMap.empty() && studentMap.count("student_id")) {
+            if (student) {
                 json data = {
                     {"role", "student"},
-                    {"studentId", stoi(studentMap.at("student_id"))},
-                    {"name", studentMap.at("name")},
+                    {"studentId", student->id},
+                    {"name", student->name},
                     {"email", idStr} // Echo back ID as email
                 };
                 
-                if (studentMap.find("class_id") != studentMap.end() && !studentMap.at("class_id").empty()) {
-                    int classId = stoi(studentMap.at("class_id"));
-                    data["classId"] = classId;
-                    data["className"] = studentMap.count("class_name") ? studentMap.at("class_name") : "Unknown";
+                if (student->classId > 0) {
+                    data["classId"] = student->classId;
+                    data["className"] = student->className;
                 } else {
                     data["classId"] = 0;
                     data["className"] = "Not Assigned";
                 }
+                addSessionToken(data, Role::Student, student->id);
                 
-                res.set_content(successResponse(data).dump(), "application/json");
+                sendJson(res, successResponse(data));
             } else {
-                res.set_content(errorResponse("Student not found").dump(), "application/json");
+                sendJson(res, errorResponse("Student not found"));
             }
         } catch (const exception& e) {
-            res.set_content(errorResponse(string("Invalid request: ") + e.what()).dump(), "application/json");
+            sendJson(res, errorResponse(string("Invalid request: ") + e.what()));
         }
     });
 }
@@ -188,30 +627,38 @@ void setupAuthEndpoints(httplib::Server& svr) {
 void setupSubjectEndpoints(httplib::Server& svr) {
     // Get all subjects
     svr.Get("/api/subjects", [](const httplib::Request& req, httplib::Response& res) {
-        auto subjects = DB_CALL(db->getAllSubjects());
-        res.set_content(successResponse(mapVectorToJson(subjects)).dump(), "application/json");
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
+        auto snap = referenceData();
+        if (notModified(req, res, *snap)) return;
+        sendJson(res, successResponse(snap->subjects));
     });
 
     // Create subject
     svr.Post("/api/subjects", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         auto body = json::parse(req.body);
         string name = body["name"];
         
         if (DB_CALL(db->createSubject(name, 100))) {
-            res.set_content(successResponse().dump(), "application/json");
+            referenceCache->refresh();
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to create subject").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to create subject"));
         }
     });
 
     // Delete subject
     svr.Delete("/api/subjects/(\\d+)", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         int subjectId = stoi(req.matches[1]);
         
         if (DB_CALL(db->deleteSubject(subjectId))) {
-            res.set_content(successResponse().dump(), "application/json");
+            referenceCache->refresh();
+            reloadTeacherAssignments();
+            attendanceIndex->forgetSubject(subjectId);
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to delete subject").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to delete subject"));
         }
     });
 }
@@ -220,58 +667,87 @@ void setupSubjectEndpoints(httplib::Server& svr) {
 void setupClassEndpoints(httplib::Server& svr) {
     // Get all classes
     svr.Get("/api/classes", [](const httplib::Request& req, httplib::Response& res) {
-        auto classes = DB_CALL(db->getAllClasses());
-        res.set_content(successResponse(mapVectorToJson(classes)).dump(), "application/json");
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
+        auto snap = referenceData();
+        if (notModified(req, res, *snap)) return;
+        sendJson(res, successResponse(snap->classes));
     });
 
     // Create class
     svr.Post("/api/classes", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         auto body = json::parse(req.body);
         string name = body["name"];
         
         if (DB_CALL(db->createClass(name))) {
-            res.set_content(successResponse().dump(), "application/json");
+            referenceCache->refresh();
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to create class").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to create class"));
         }
     });
 
     // Delete class
     svr.Delete("/api/classes/(\\d+)", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         int classId = stoi(req.matches[1]);
         
         if (DB_CALL(db->deleteClass(classId))) {
-            res.set_content(successResponse().dump(), "application/json");
+            referenceCache->refresh();
+            reloadTeacherAssignments();
+            attendanceIndex->scheduleRebuild();  // the class's records went with it
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to delete class").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to delete class"));
         }
     });
 
     // Get subjects for a class
     svr.Get("/api/classes/(\\d+)/subjects", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
         int classId = stoi(req.matches[1]);
-        auto subjects = DB_CALL(db->getClassSubjects(classId));
-        res.set_content(successResponse(mapVectorToJson(subjects)).dump(), "application/json");
+        auto snap = referenceData();
+        if (notModified(req, res, *snap)) return;
+        sendJson(res, successResponse(snap->subjectsForClass(classId)));
     });
 
     // Add subject to class
     svr.Post("/api/classes/(\\d+)/subjects", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         int classId = stoi(req.matches[1]);
         auto body = json::parse(req.body);
         int subjectId = getIntField(body, "subjectId", 0);
         
         if (DB_CALL(db->addSubjectToClass(classId, subjectId))) {
-            res.set_content(successResponse().dump(), "application/json");
+            referenceCache->refresh();
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to add subject to class").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to add subject to class"));
         }
     });
 
     // Get students in a class
     svr.Get("/api/classes/(\\d+)/students", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
         int classId = stoi(req.matches[1]);
-        auto students = DB_CALL(db->getStudentsByClass(classId));
-        res.set_content(successResponse(mapVectorToJson(students)).dump(), "application/json");
+        if (!mayAccessClass(*session, classId)) return forbid(res);
+        if (notModified(req, res, Tables::Students)) return;
+        coalesce(req, res, [&](httplib::Response& res) {
+            auto students = DB_CALL(db->getStudentsByClass(classId));
+        
+            string& body = jsonBuffer();
+            JsonWriter out(body);
+            beginSuccess(out).beginArray();
+            for (const auto& student : students) {
+                out.beginObject()
+                   .field("id", student.id)
+                   .field("name", student.name)
+                   .field("classId", student.classId)
+                   .endObject();
+            }
+            out.endArray().endObject();
+            sendJson(res, body);
+        });
     });
 }
 
@@ -279,87 +755,95 @@ void setupClassEndpoints(httplib::Server& svr) {
 void setupTeacherEndpoints(httplib::Server& svr) {
     // Get all teachers (Optimized)
     svr.Get("/api/teachers", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
         try {
-            auto teachers = DB_CALL(db->getAllTeachersWithDetails());
-            json result = json::array();
+            auto snap = referenceData();
+            if (notModified(req, res, *snap)) return;
             
-            for (const auto& teacherMap : teachers) {
-                if (!teacherMap.count("teacher_id") || !teacherMap.count("name")) {
-                    continue; // Skip invalid entries
-                }
-                
-                json teacher;
-                teacher["id"] = teacherMap.at("teacher_id");
-                teacher["name"] = teacherMap.at("name");
-                teacher["email"] = teacherMap.count("email") ? teacherMap.at("email") : "";
-                teacher["type"] = teacherMap.count("teacher_type") ? teacherMap.at("teacher_type") : "Teacher";
-                
-                if (teacherMap.find("salary") != teacherMap.end()) {
-                    teacher["salary"] = teacherMap.at("salary");
-                }
-                if (teacherMap.find("join_date") != teacherMap.end()) {
-                    teacher["joinDate"] = teacherMap.at("join_date");
-                }
+            string& body = jsonBuffer();
+            JsonWriter out(body);
+            beginSuccess(out).beginArray();
+            
+            for (const auto& t : snap->teachers) {
+                out.beginObject()
+                   .field("id", t.id)
+                   .field("name", t.name)
+                   .field("email", t.email)
+                   .field("type", t.type.empty() ? "Teacher" : t.type)
+                   .field("salary", t.salary)
+                   .field("joinDate", t.joinDate.isValid() ? t.joinDate.toString() : "");
                 
-                // Class info is now already in the map from the JOIN
-                if (teacherMap.count("class_id") && !teacherMap.at("class_id").empty()) {
-                    teacher["classId"] = stoi(teacherMap.at("class_id"));
-                    teacher["className"] = teacherMap.count("class_name") ? teacherMap.at("class_name") : "Unknown";
+                // Class info comes from the JOIN
+                if (t.classId > 0) {
+                    out.field("classId", t.classId).field("className", t.className);
                 } else {
-                    teacher["classId"] = 0;
-                    teacher["className"] = "Not Assigned";
+                    out.field("classId", 0).field("className", "Not Assigned");
                 }
-                
-                result.push_back(teacher);
+                out.endObject();
             }
             
-            res.set_content(successResponse(result).dump(), "application/json");
+            out.endArray().endObject();
+            sendJson(res, body);
         } catch (const exception& e) {
-            res.set_content(errorResponse(string("Internal Error: ") + e.what()).dump(), "application/json");
+            sendJson(res, errorResponse(string("Internal Error: ") + e.what()));
         }
     });
 
     // Create teacher
     svr.Post("/api/teachers", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         auto body = json::parse(req.body);
         string name = body["name"];
         string email = body["email"];
         string password = body["password"];
         string type = body.contains("type") ? body["type"] : "Teacher";
         
-        if (DB_CALL(db->createTeacher(name, email, password, 50000.0, "2025-12-01", type))) {
-            res.set_content(successResponse().dump(), "application/json");
+        if (DB_CALL(db->createTeacher(name, email, password, 50000.0, Date::fromCivil(2025, 12, 1), type))) {
+            referenceCache->refresh();
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to create teacher").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to create teacher"));
         }
     });
 
     // Delete teacher
     svr.Delete("/api/teachers/(\\d+)", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         int teacherId = stoi(req.matches[1]);
         
         if (DB_CALL(db->deleteTeacher(teacherId))) {
-            res.set_content(successResponse().dump(), "application/json");
+            referenceCache->refresh();
+            reloadTeacherAssignments();
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to delete teacher").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to delete teacher"));
         }
     });
 
     // Assign class teacher
     svr.Post("/api/teachers/(\\d+)/assign-class", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         int teacherId = stoi(req.matches[1]);
         auto body = json::parse(req.body);
         int classId = getIntField(body, "classId", 0);
         
         if (DB_CALL(db->assignClassTeacher(classId, teacherId))) {
-            res.set_content(successResponse().dump(), "application/json");
+            referenceCache->refresh();
+            ClassInfo assigned;
+            assigned.id = classId;
+            if (auto snap = referenceCache->snapshot()) {
+                if (const ClassInfo* cls = snap->findClass(classId)) assigned.name = cls->name;
+            }
+            teacherAssignments->assignClassTeacher(assigned, teacherId);
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to assign class teacher").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to assign class teacher"));
         }
     });
 
     // Assign subject teacher
     svr.Post("/api/teachers/(\\d+)/assign-subject", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         int teacherId = stoi(req.matches[1]);
         auto body = json::parse(req.body);
         int subjectId = getIntField(body, "subjectId", 0);
@@ -367,137 +851,163 @@ void setupTeacherEndpoints(httplib::Server& svr) {
         
         if (classId == 0) {
             // Fallback: try to get class from teacher's class assignment
-            auto classAssignment = DB_CALL(db->getTeacherClassAssignment(teacherId));
-            if (!classAssignment.empty()) {
-                classId = stoi(classAssignment["class_id"]);
+            auto classAssignment = teacherAssignments->classOf(teacherId);
+            if (classAssignment) {
+                classId = classAssignment->id;
             }
         }
         
         if (classId == 0) {
-            res.set_content(errorResponse("Class ID is missing. Please select a class.").dump(), "application/json");
+            sendJson(res, errorResponse("Class ID is missing. Please select a class."));
             return;
         }
         
         if (DB_CALL(db->assignSubjectTeacher(teacherId, subjectId, classId))) {
-            res.set_content(successResponse().dump(), "application/json");
+            Assignment assignment;
+            assignment.subjectId = subjectId;
+            assignment.classId = classId;
+            if (auto snap = referenceCache->snapshot()) {
+                if (const Subject* subject = snap->findSubject(subjectId)) assignment.subjectName = subject->name;
+                if (const ClassInfo* cls = snap->findClass(classId)) assignment.className = cls->name;
+            }
+            teacherAssignments->assignSubjectTeacher(teacherId, assignment);
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to assign subject teacher. This assignment might already exist.").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to assign subject teacher. This assignment might already exist."));
         }
     });
 
     // Get teacher's assigned subjects
     svr.Get("/api/teachers/(\\d+)/subjects", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
         int teacherId = stoi(req.matches[1]);
+        if (!ownsRecord(*session, Role::Teacher, teacherId)) return forbid(res);
+        if (notModified(req, res, Tables::TeacherSubjects | Tables::Subjects | Tables::Classes)) return;
         auto subjects = DB_CALL(db->getTeacherSubjectAssignments(teacherId));
         
         json result = json::array();
         for (const auto& s : subjects) {
-            json subject;
-            subject["id"] = s.count("subject_id") ? s.at("subject_id") : "0";
-            subject["name"] = s.count("subject_name") ? s.at("subject_name") : "Unknown";
-            subject["classId"] = s.count("class_id") ? s.at("class_id") : "0";
-            subject["className"] = s.count("class_name") ? s.at("class_name") : "Unknown";
-            result.push_back(subject);
+            result.push_back({
+                {"id", s.subjectId},
+                {"name", s.subjectName},
+                {"classId", s.classId},
+                {"className", s.className}
+            });
         }
         
-        res.set_content(successResponse(result).dump(), "application/json");
+        sendJson(res, successResponse(result));
     });
 }
 
 // Student endpoints
 void setupStudentEndpoints(httplib::Server& svr) {
-    // Get all students
+    // List students one page at a time: ?limit=N (default 100, max 500) and
+    // ?cursor=<last id of the previous page>. nextCursor is null on the last page.
     svr.Get("/api/students", [](const httplib::Request& req, httplib::Response& res) {
-        try {
-            auto students = DB_CALL(db->getAllStudents());
-            json result = json::array();
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
+        int limit = 100, cursor = 0;
+        if (!getIntParam(req, "limit", limit)) return invalidParam(res, "limit");
+        if (!getIntParam(req, "cursor", cursor)) return invalidParam(res, "cursor");
+        limit = max(1, min(limit, 500));
+        if (notModified(req, res, Tables::Students | Tables::Classes)) return;
+        coalesce(req, res, [&](httplib::Response& res) {
+            try {
             
-            for (const auto& studentMap : students) {
-                if (!studentMap.count("student_id") || !studentMap.count("name")) {
-                    continue; // Skip invalid entries
-                }
-                
-                json student;
-                student["id"] = studentMap.at("student_id");
-                student["name"] = studentMap.at("name");
+                // One extra row tells us whether another page follows
+                auto students = DB_CALL(db->getStudentsPage(cursor, limit + 1));
+                int total = DB_CALL(db->countStudents());
+                bool hasMore = students.size() > static_cast<size_t>(limit);
+                if (hasMore) students.pop_back();
             
-                // Handle class assignment
-                if (studentMap.find("class_id") != studentMap.end() && !studentMap.at("class_id").empty() && studentMap.at("class_id") != "0") {
-                    int classId = stoi(studentMap.at("class_id"));
-                    student["classId"] = classId;
-                    auto classInfo = DB_CALL(db->getClassById(classId));
-                    if (!classInfo.empty() && classInfo.find("class_name") != classInfo.end()) {
-                        student["className"] = classInfo["class_name"];
-                    } else {
-                        student["className"] = "Unknown";
-                    }
-                } else {
-                    student["classId"] = 0;
-                    student["className"] = "Not Assigned";
+                string& body = jsonBuffer();
+                JsonWriter out(body);
+                beginSuccess(out).beginArray();
+                for (const auto& s : students) {
+                    out.beginObject()
+                       .field("id", s.id)
+                       .field("name", s.name)
+                       .field("classId", s.classId)
+                       .field("className", s.classId > 0 ? s.className : "Not Assigned")
+                       .endObject();
                 }
-                
-                result.push_back(student);
+                out.endArray().field("total", total).key("nextCursor");
+                if (hasMore) out.value(students.back().id);
+                else out.null();
+                out.endObject();
+                sendJson(res, body);
+            } catch (const exception& e) {
+                sendJson(res, errorResponse(string("Error loading students: ") + e.what()));
             }
-            
-            res.set_content(successResponse(result).dump(), "application/json");
-        } catch (const exception& e) {
-            res.set_content(errorResponse(string("Error loading students: ") + e.what()).dump(), "application/json");
-        }
+        });
     });
 
     // Create student
     svr.Post("/api/students", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         auto body = json::parse(req.body);
         string name = body["name"];
         
         int newId = DB_CALL(db->createStudent(name, 0));
         if (newId > 0) {
-            res.set_content(successResponse({{"id", newId}}).dump(), "application/json");
+            sendJson(res, successResponse({{"id", newId}}));
         } else {
-            res.set_content(errorResponse("Failed to create student").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to create student"));
         }
     });
 
     // Delete student
     svr.Delete("/api/students/(\\d+)", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
         int studentId = stoi(req.matches[1]);
         
         if (DB_CALL(db->deleteStudent(studentId))) {
-            res.set_content(successResponse().dump(), "application/json");
+            attendanceIndex->forgetStudent(studentId);
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to delete student").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to delete student"));
         }
     });
 
     // Assign student to class
     svr.Post("/api/students/(\\d+)/assign-class", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
         int studentId = stoi(req.matches[1]);
         auto body = json::parse(req.body);
         int classId = getIntField(body, "classId", 0);
+        // Class teachers may only bring students into their own class
+        if (session->role == Role::Teacher && teacherAssignments->classTeacherOf(classId) != session->id) {
+            return forbid(res);
+        }
         
         auto student = DB_CALL(db->getStudentById(studentId));
-        if (!student.empty()) {
+        if (student && session->role == Role::Teacher && student->classId != 0) {
+            return forbid(res);  // already in another class
+        }
+        if (student) {
             DB_CALL(db->deleteStudent(studentId));
-            if (DB_CALL(db->createStudent(student["name"], classId))) {
-                res.set_content(successResponse().dump(), "application/json");
+            attendanceIndex->forgetStudent(studentId);
+            if (DB_CALL(db->createStudent(student->name, classId))) {
+                sendJson(res, successResponse());
             } else {
-                res.set_content(errorResponse("Failed to assign student").dump(), "application/json");
+                sendJson(res, errorResponse("Failed to assign student"));
             }
         } else {
-            res.set_content(errorResponse("Student not found").dump(), "application/json");
+            sendJson(res, errorResponse("Student not found"));
         }
     });
 
     // Update student profile
     svr.Put("/api/students/(\\d+)/profile", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Student);
         int studentId = stoi(req.matches[1]);
+        if (!ownsRecord(*session, Role::Student, studentId)) return forbid(res);
         auto body = json::parse(req.body);
         string newName = body["name"];
         
         if (DB_CALL(db->updateStudentName(studentId, newName))) {
-            res.set_content(successResponse().dump(), "application/json");
+            sendJson(res, successResponse());
         } else {
-            res.set_content(errorResponse("Failed to update profile").dump(), "application/json");
+            sendJson(res, errorResponse("Failed to update profile"));
         }
     });
 }
@@ -506,152 +1016,448 @@ void setupStudentEndpoints(httplib::Server& svr) {
 void setupAttendanceEndpoints(httplib::Server& svr) {
     // Mark attendance
     svr.Post("/api/attendance", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
         try {
             auto body = json::parse(req.body);
             if (!body.contains("studentId") || !body.contains("subjectId") || 
                 !body.contains("date") || !body.contains("status")) {
-                res.set_content(errorResponse("Missing required fields").dump(), "application/json");
+                sendJson(res, errorResponse("Missing required fields"));
                 return;
             }
             int studentId = getIntField(body, "studentId", 0);
             int subjectId = getIntField(body, "subjectId", 0);
-            string date = body["date"];
-            string status = body["status"];
-        
-        auto student = DB_CALL(db->getStudentById(studentId));
-        int classId = 0;
-        if (!student.empty() && student.find("class_id") != student.end() && !student["class_id"].empty()) {
-            classId = stoi(student["class_id"]);
+            int classId = getIntField(body, "classId", 0);
+            Date date = Date::parse(body["date"].get<string>());
+            AttendanceStatus status = parseAttendanceStatus(body["status"]);
+            if (session->role == Role::Teacher && !teacherAssignments->canMark(session->id, subjectId, classId)) {
+                return forbid(res);
+            }
+            
+            if (!date.isValid()) {
+                sendJson(res, errorResponse("Invalid date, expected YYYY-MM-DD"));
+                return;
+            }
+            if (status == AttendanceStatus::Unknown) {
+                sendJson(res, errorResponse("Invalid status"));
+                return;
+            }
+            
+            // Queued for the next group commit; waits for that batch to land
+            MarkAttendanceResult result;
+            {
+                static Histogram& queuedMark = dbCallLatency->get("markAttendanceBatch (queued)");
+                DbTimer dbTimer(queuedMark);
+                result = writeQueue->submit({studentId, subjectId, date, toString(status), classId}).get();
+            }
+            if (result == MarkAttendanceResult::Marked) {
+                attendanceIndex->record(studentId, subjectId, date, status);
+                tableVersions->bump(Tables::Attendance);
+                sendJson(res, successResponse());
+            } else {
+                sendJson(res, errorResponse(markResultMessage(result)));
+            }
+        } catch (const exception& e) {
+            sendJson(res, errorResponse(string("Error marking attendance: ") + e.what()));
         }
+    });
 
-            if (classId == 0) {
-                res.set_content(errorResponse("Student is not assigned to any class").dump(), "application/json");
+    // Mark attendance for a whole class session in one transaction
+    svr.Post("/api/attendance/bulk", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
+        try {
+            auto body = json::parse(req.body);
+            if (!body.contains("subjectId") || !body.contains("date") ||
+                !body.contains("records") || !body["records"].is_array()) {
+                sendJson(res, errorResponse("Missing required fields"));
                 return;
             }
-
-            // Verify subject is assigned to student's class
-            auto classSubjects = DB_CALL(db->getClassSubjects(classId));
-            bool subjectInClass = false;
-            for (const auto& s : classSubjects) {
-                auto it = s.find("subject_id");
-                if (it != s.end()) {
-                    try {
-                        if (stoi(it->second) == subjectId) { subjectInClass = true; break; }
-                    } catch (...) {}
-                }
+            int subjectId = getIntField(body, "subjectId", 0);
+            int classId = getIntField(body, "classId", 0);
+            Date date = Date::parse(body["date"].get<string>());
+            // Teachers mark one class they teach the subject in; the write
+            // then rejects any listed student outside that class
+            if (session->role == Role::Teacher && !teacherAssignments->canMark(session->id, subjectId, classId)) {
+                return forbid(res);
             }
-            if (!subjectInClass) {
-                res.set_content(errorResponse("Subject is not assigned to the student's class").dump(), "application/json");
+            if (!date.isValid()) {
+                sendJson(res, errorResponse("Invalid date, expected YYYY-MM-DD"));
                 return;
             }
-
-            // Check duplicate attendance for same student-subject-date
-            if (DB_CALL(db->isAttendanceMarked(studentId, subjectId, date))) {
-                res.set_content(errorResponse("Attendance already marked for this student, subject, and date").dump(), "application/json");
+            
+            const size_t maxRecords = 1000;
+            if (body["records"].size() > maxRecords) {
+                sendJson(res, errorResponse("Too many records in one request"));
                 return;
             }
-        
-            if (classId > 0 && DB_CALL(db->markAttendance(studentId, subjectId, classId, date, status))) {
-                res.set_content(successResponse().dump(), "application/json");
-            } else {
-                res.set_content(errorResponse("Failed to mark attendance").dump(), "application/json");
+            
+            // Statuses are checked up front and stored normalized; one bad
+            // record rejects the request before anything is written
+            vector<AttendanceMark> marks;
+            vector<AttendanceStatus> statuses;
+            marks.reserve(body["records"].size());
+            statuses.reserve(body["records"].size());
+            for (const auto& record : body["records"]) {
+                if (!record.contains("studentId") || !record.contains("status")) {
+                    sendJson(res, errorResponse("Each record needs studentId and status"));
+                    return;
+                }
+                int studentId = getIntField(record, "studentId", 0);
+                const auto& statusField = record["status"];
+                AttendanceStatus status = statusField.is_string() ? parseAttendanceStatus(statusField.get<string>())
+                                                                  : AttendanceStatus::Unknown;
+                if (status == AttendanceStatus::Unknown) {
+                    res.status = 400;
+                    sendJson(res, errorResponse("Invalid status for student " + to_string(studentId) +
+                                                " (record " + to_string(marks.size() + 1) + ")"));
+                    return;
+                }
+                marks.push_back({studentId, toString(status)});
+                statuses.push_back(status);
             }
+            
+            auto results = DB_CALL(db->markAttendanceBulk(subjectId, date, marks, classId));
+            
+            json data = json::array();
+            int markedCount = 0;
+            for (size_t i = 0; i < marks.size(); ++i) {
+                json entry = {{"studentId", marks[i].studentId}};
+                if (results[i] == MarkAttendanceResult::Marked) {
+                    attendanceIndex->record(marks[i].studentId, subjectId, date, statuses[i]);
+                    entry["success"] = true;
+                    markedCount++;
+                } else {
+                    entry["success"] = false;
+                    entry["error"] = markResultMessage(results[i]);
+                }
+                data.push_back(entry);
+            }
+            
+            sendJson(res, successResponse({
+                {"marked", markedCount},
+                {"failed", static_cast<int>(marks.size()) - markedCount},
+                {"results", data}
+            }));
         } catch (const exception& e) {
-            res.set_content(errorResponse(string("Error marking attendance: ") + e.what()).dump(), "application/json");
+            sendJson(res, errorResponse(string("Error marking attendance: ") + e.what()));
         }
     });
 
     // Get student attendance by subject
     svr.Get("/api/students/(\\d+)/attendance/subject/(\\d+)", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
         int studentId = stoi(req.matches[1]);
-        int subjectId = stoi(req.matches[2]);
+        if (!ownsRecord(*session, Role::Student, studentId)) return forbid(res);
+        if (notModified(req, res, Tables::Attendance | Tables::Subjects)) return;
+        coalesce(req, res, [&](httplib::Response& res) {
+            int subjectId = stoi(req.matches[2]);
         
-        auto allRecords = DB_CALL(db->getStudentAttendance(studentId));
-        json result = json::array();
+            auto allRecords = DB_CALL(db->getStudentAttendance(studentId));
         
-        for (const auto& recordMap : allRecords) {
-            if (recordMap.find("subject_id") != recordMap.end() && stoi(recordMap.at("subject_id")) == subjectId) {
-                json record;
-                for (const auto& pair : recordMap) {
-                    record[pair.first] = pair.second;
+            string& body = jsonBuffer();
+            JsonWriter out(body);
+            beginSuccess(out).beginArray();
+            for (const auto& record : allRecords) {
+                if (record.subjectId == subjectId) {
+                    writeRecord(out, record);
                 }
-                result.push_back(record);
             }
-        }
-        
-        res.set_content(successResponse(result).dump(), "application/json");
+            out.endArray().endObject();
+            sendJson(res, body);
+        });
     });
 
     // Get overall attendance percentage
     svr.Get("/api/students/(\\d+)/attendance-percentage", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
         int studentId = stoi(req.matches[1]);
+        if (!ownsRecord(*session, Role::Student, studentId)) return forbid(res);
+        if (notModified(req, res, Tables::Attendance)) return;
         
-        auto allRecords = DB_CALL(db->getStudentAttendance(studentId));
-        int totalDays = allRecords.size();
-        int presentDays = 0;
-        
-        for (const auto& record : allRecords) {
-            if (record.count("status") && (record.at("status") == "Present" || record.at("status") == "present")) {
-                presentDays++;
-            }
-        }
-        
-        double percentage = totalDays > 0 ? (presentDays * 100.0 / totalDays) : 0.0;
-        res.set_content(successResponse({{"percentage", percentage}}).dump(), "application/json");
+        double percentage = DB_CALL(db->getAttendancePercentage(studentId, 0));
+        sendJson(res, successResponse({{"percentage", percentage}}));
     });
 
     // Get subject attendance percentage
     svr.Get("/api/students/(\\d+)/attendance-percentage/subject/(\\d+)", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
         int studentId = stoi(req.matches[1]);
+        if (!ownsRecord(*session, Role::Student, studentId)) return forbid(res);
         int subjectId = stoi(req.matches[2]);
+        if (notModified(req, res, Tables::Attendance)) return;
         
         double percentage = DB_CALL(db->getAttendancePercentage(studentId, subjectId));
-        res.set_content(successResponse({{"percentage", percentage}}).dump(), "application/json");
+        sendJson(res, successResponse({{"percentage", percentage}}));
+    });
+
+    // Everything the student portal's overview needs in one response:
+    // overall and per-subject counts from attendance_summary plus the most
+    // recent records (?recent=N, default 10, max 100). Three queries however
+    // many subjects the student takes.
+    svr.Get("/api/students/(\\d+)/dashboard", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher, Role::Student);
+        int studentId = stoi(req.matches[1]);
+        if (!ownsRecord(*session, Role::Student, studentId)) return forbid(res);
+        int recentLimit = 10;
+        if (!getIntParam(req, "recent", recentLimit)) return invalidParam(res, "recent");
+        recentLimit = max(1, min(recentLimit, 100));
+        // One snapshot for both the ETag and the subject list, so they agree
+        auto snap = referenceData();
+        if (notModified(req, res, Tables::All, snap->generation)) return;
+        
+        auto student = DB_CALL(db->getStudentById(studentId));
+        if (!student) {
+            sendJson(res, errorResponse("Student not found"));
+            return;
+        }
+        
+        auto summaries = DB_CALL(db->getAttendanceSummary(studentId));
+        auto recent = DB_CALL(db->getRecentAttendance(studentId, recentLimit));
+        
+        string& body = jsonBuffer();
+        JsonWriter out(body);
+        beginSuccess(out).beginObject()
+            .field("studentId", student->id)
+            .field("name", student->name)
+            .field("classId", student->classId)
+            .field("className", student->classId > 0 ? student->className : "Not Assigned");
+        
+        auto writeSubject = [&out](int id, const string& name, const AttendanceSummary& summary) {
+            out.beginObject()
+               .field("id", id)
+               .field("name", name)
+               .field("total", summary.total)
+               .field("present", summary.present)
+               .field("percentage", summary.percentage())
+               .endObject();
+        };
+        
+        // Every subject of the student's class, including ones not yet marked,
+        // then any other subject they have records for (e.g. from a former class)
+        AttendanceSummary overall;
+        unordered_set<int> listed;
+        out.key("subjects").beginArray();
+        
+        for (const auto& subject : snap->subjectsForClass(student->classId)) {
+            AttendanceSummary counts;
+            for (const auto& summary : summaries) {
+                if (summary.subjectId == subject.id) counts = summary;
+            }
+            writeSubject(subject.id, subject.name, counts);
+            listed.insert(subject.id);
+        }
+        
+        for (const auto& summary : summaries) {
+            overall.total += summary.total;
+            overall.present += summary.present;
+            if (!listed.count(summary.subjectId)) {
+                writeSubject(summary.subjectId, summary.subjectName, summary);
+            }
+        }
+        out.endArray();
+        
+        out.key("overall").beginObject()
+           .field("total", overall.total)
+           .field("present", overall.present)
+           .field("percentage", overall.percentage())
+           .endObject();
+        
+        out.key("recent").beginArray();
+        for (const auto& record : recent) {
+            writeRecord(out, record);
+        }
+        out.endArray().endObject().endObject();
+        sendJson(res, body);
     });
 
     // Get class attendance for a date
     svr.Get("/api/classes/(\\d+)/attendance", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
         int classId = stoi(req.matches[1]);
-        string date = req.get_param_value("date");
-        int subjectId = stoi(req.get_param_value("subjectId"));
+        if (!mayAccessClass(*session, classId)) return forbid(res);
+        int subjectId = 0;
+        if (!getIntParam(req, "subjectId", subjectId, true)) return invalidParam(res, "subjectId");
+        if (notModified(req, res, Tables::Students | Tables::Attendance)) return;
+        coalesce(req, res, [&](httplib::Response& res) {
+            Date date = Date::parse(req.get_param_value("date"));
+            if (!date.isValid()) {
+                sendJson(res, errorResponse("Invalid date, expected YYYY-MM-DD"));
+                return;
+            }
         
-        auto students = DB_CALL(db->getStudentsByClass(classId));
-        json result = json::array();
+            auto sheet = DB_CALL(db->getClassSessionSheet(classId, subjectId, date));
         
-        for (const auto& studentMap : students) {
-            if (!studentMap.count("id") || !studentMap.count("name")) continue;
-            
-            int studentId = stoi(studentMap.at("id"));
-            auto records = DB_CALL(db->getStudentAttendance(studentId));
-            string status = "Not Marked";
+            string& body = jsonBuffer();
+            JsonWriter out(body);
+            beginSuccess(out).beginArray();
+            for (const auto& entry : sheet) {
+                out.beginObject()
+                   .field("studentId", entry.studentId)
+                   .field("studentName", entry.studentName)
+                   .field("status", entry.marked ? toString(entry.status) : "Not Marked")
+                   .endObject();
+            }
+            out.endArray().endObject();
+            sendJson(res, body);
+        });
+    });
+
+    // Export a class's whole attendance history as CSV. Rows are read a
+    // keyset page at a time and the connection goes back to the pool before
+    // each page is written, so a slow download never holds a pooled lease.
+    svr.Get("/api/classes/(\\d+)/attendance/export", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
+        int classId = stoi(req.matches[1]);
+        if (!mayAccessClass(*session, classId)) return forbid(res);
+        res.set_header("Content-Disposition",
+                       "attachment; filename=\"class-" + to_string(classId) + "-attendance.csv\"");
+        
+        res.set_chunked_content_provider("text/csv", [classId](size_t, httplib::DataSink& sink) {
+            const int pageSize = 2000;
+            string buffer = "date,student_id,student,subject_id,subject,status\n";
+            AttendanceRecord after;  // no date yet: the first page
             
-            for (const auto& record : records) {
-                if (record.count("date") && record.count("status") && 
-                    record.at("date") == date && record.find("subject_id") != record.end() && 
-                    stoi(record.at("subject_id")) == subjectId) {
-                    status = record.at("status");
-                    break;
+            while (true) {
+                vector<AttendanceRecord> page;
+                try {
+                    page = DB_CALL(db->getClassAttendancePage(classId, after, pageSize));
+                } catch (const exception& e) {
+                    cerr << "Attendance export failed: " << e.what() << endl;
+                    return false;
+                }
+                
+                for (const auto& record : page) {
+                    buffer += record.date.toString();
+                    buffer += ',';
+                    buffer += to_string(record.studentId);
+                    buffer += ',';
+                    appendCsvField(buffer, record.studentName);
+                    buffer += ',';
+                    buffer += to_string(record.subjectId);
+                    buffer += ',';
+                    appendCsvField(buffer, record.subjectName);
+                    buffer += ',';
+                    buffer += toString(record.status);
+                    buffer += '\n';
                 }
+                
+                // Stop once the client has gone
+                if (!buffer.empty() && !sink.write(buffer.data(), buffer.size())) return false;
+                buffer.clear();
+                
+                if (page.size() < static_cast<size_t>(pageSize)) break;
+                after = move(page.back());
             }
             
-            result.push_back({
-                {"studentId", studentId},
-                {"studentName", studentMap.at("name")},
-                {"status", status}
-            });
-        }
+            sink.done();
+            return true;
+        });
+    });
+
+    // Per-student totals for the whole school over a date range
+    // (?from=&to=, YYYY-MM-DD, default the whole term), from the bitset index
+    svr.Get("/api/reports/attendance", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin);
+        coalesce(req, res, [&](httplib::Response& res) {
+            Date from, to;
+            if (!getDateParam(req, "from", from) || !getDateParam(req, "to", to)) {
+                sendJson(res, errorResponse("Invalid date, expected YYYY-MM-DD"));
+                return;
+            }
+        
+            string& body = jsonBuffer();
+            JsonWriter out(body);
+            beginSuccess(out).beginObject()
+                .field("termStart", attendanceIndex->termStart().toString())
+                .field("termEnd", attendanceIndex->termEnd().toString());
+        
+            AttendanceBitmapIndex::Counts overall;
+            out.key("students").beginArray();
+            for (const auto& entry : attendanceIndex->schoolReport(from, to)) {
+                overall.total += entry.counts.total;
+                overall.present += entry.counts.present;
+                out.beginObject()
+                   .field("studentId", entry.studentId)
+                   .field("total", entry.counts.total)
+                   .field("present", entry.counts.present)
+                   .field("percentage", entry.counts.percentage())
+                   .endObject();
+            }
+            out.endArray();
+        
+            out.key("overall").beginObject()
+               .field("total", overall.total)
+               .field("present", overall.present)
+               .field("percentage", overall.percentage())
+               .endObject();
+            out.endObject().endObject();
+            sendJson(res, body);
+        });
+    });
+
+    // One subject's attendance across a class over a date range:
+    // sessions held, sessions with full attendance and per-student counts
+    svr.Get("/api/classes/(\\d+)/attendance/report", [](const httplib::Request& req, httplib::Response& res) {
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
+        int classId = stoi(req.matches[1]);
+        if (!mayAccessClass(*session, classId)) return forbid(res);
+        int subjectId = 0;
+        if (!getIntParam(req, "subjectId", subjectId, true)) return invalidParam(res, "subjectId");
+        coalesce(req, res, [&](httplib::Response& res) {
+            Date from, to;
+            if (!getDateParam(req, "from", from) || !getDateParam(req, "to", to)) {
+                sendJson(res, errorResponse("Invalid date, expected YYYY-MM-DD"));
+                return;
+            }
+        
+            auto roster = DB_CALL(db->getStudentsByClass(classId));
+            vector<int> studentIds;
+            for (const auto& student : roster) {
+                studentIds.push_back(student.id);
+            }
+            auto report = attendanceIndex->classReport(studentIds, subjectId, from, to);
+        
+            string& body = jsonBuffer();
+            JsonWriter out(body);
+            beginSuccess(out).beginObject()
+                .field("classId", classId)
+                .field("subjectId", subjectId)
+                .field("sessions", report.sessions)
+                .field("perfectDays", report.perfectDays)
+                .field("total", report.counts.total)
+                .field("present", report.counts.present)
+                .field("percentage", report.counts.percentage());
         
-        res.set_content(successResponse(result).dump(), "application/json");
+            out.key("students").beginArray();
+            for (const auto& student : roster) {
+                auto counts = attendanceIndex->studentSubject(student.id, subjectId, from, to);
+                out.beginObject()
+                   .field("studentId", student.id)
+                   .field("studentName", student.name)
+                   .field("total", counts.total)
+                   .field("present", counts.present)
+                   .field("percentage", counts.percentage())
+                   .endObject();
+            }
+            out.endArray().endObject().endObject();
+            sendJson(res, body);
+        });
     });
 
     // Check if attendance marked
     svr.Get("/api/attendance/check", [](const httplib::Request& req, httplib::Response& res) {
-        int studentId = stoi(req.get_param_value("studentId"));
-        int subjectId = stoi(req.get_param_value("subjectId"));
-        string date = req.get_param_value("date");
+        REQUIRE_ROLE(Role::Admin, Role::Teacher);
+        int studentId = 0, subjectId = 0;
+        if (!getIntParam(req, "studentId", studentId, true)) return invalidParam(res, "studentId");
+        if (!getIntParam(req, "subjectId", subjectId, true)) return invalidParam(res, "subjectId");
+        Date date = Date::parse(req.get_param_value("date"));
+        if (!date.isValid()) {
+            sendJson(res, errorResponse("Invalid date, expected YYYY-MM-DD"));
+            return;
+        }
         
+        if (notModified(req, res, Tables::Attendance)) return;
         bool isMarked = DB_CALL(db->isAttendanceMarked(studentId, subjectId, date));
-        res.set_content(successResponse({{"isMarked", isMarked}}).dump(), "application/json");
+        sendJson(res, successResponse({{"isMarked", isMarked}}));
     });
 }
 
@@ -672,16 +1478,82 @@ int main() {
         return 1;
     }
 
-    // Initialize database
-    db = new Database(config);
+    // Initialize database connection pool
+    pool = new ConnectionPool(config);
 
-    if (!db->isConnected()) {
+    if (!pool->isConnected()) {
         cerr << "Failed to connect to database!" << endl;
-        delete db;
+        delete pool;
         return 1;
     }
 
-    cout << "Database connected successfully!" << endl;
+    cout << "Database connected successfully! (pool " << pool->size() << "/"
+         << pool->maxSize() << " connections)" << endl;
+
+    // Bring the schema up to date unless disabled (auto_migrate=false). The
+    // in-memory backend is created at the latest schema and has nothing to run.
+    if (!config.count("auto_migrate") || config.at("auto_migrate") != "false") {
+        auto lease = pool->acquire();
+        auto* mysqlDb = dynamic_cast<MySqlDatabase*>(lease.get());
+        if (!lease || (mysqlDb && !Migrations::run(*mysqlDb))) {
+            cerr << "Schema migration failed!" << endl;
+            delete pool;
+            return 1;
+        }
+    }
+
+    // Warm the reference cache so the first dashboard load is served from memory
+    referenceCache = new ReferenceCache(*pool);
+    if (!referenceCache->refresh()) {
+        cerr << "Warning: reference cache not loaded; it will retry on first use" << endl;
+    }
+
+    teacherAssignments = new TeacherAssignmentIndex();
+    if (auto lease = pool->acquire()) {
+        teacherAssignments->load(*lease.get());
+        cout << "Teacher assignments: " << teacherAssignments->assignmentCount() << " loaded" << endl;
+    } else {
+        cerr << "Warning: teacher assignments not loaded; teachers cannot mark attendance" << endl;
+    }
+
+    size_t batchSize = config.count("write_batch_size") ? stoul(config.at("write_batch_size")) : 64;
+    int batchDelayMs = config.count("write_batch_delay_ms") ? stoi(config.at("write_batch_delay_ms")) : 2;
+    writeQueue = new AttendanceWriteQueue(*pool, batchSize, chrono::milliseconds(batchDelayMs));
+
+    // Term for the report index (term_start/term_end), default this calendar year
+    int year = Date::today().year();
+    Date termStart = config.count("term_start") ? Date::parse(config.at("term_start")) : Date::fromCivil(year, 1, 1);
+    Date termEnd = config.count("term_end") ? Date::parse(config.at("term_end")) : Date::fromCivil(year, 12, 31);
+    if (!termStart.isValid() || !termEnd.isValid() || termEnd < termStart) {
+        cerr << "Invalid term_start/term_end, using " << year << endl;
+        termStart = Date::fromCivil(year, 1, 1);
+        termEnd = Date::fromCivil(year, 12, 31);
+    }
+
+    attendanceIndex = new AttendanceBitmapIndex(*pool, termStart, termEnd);
+    if (attendanceIndex->rebuild()) {
+        cout << "Attendance index: " << attendanceIndex->rowCount() << " student/subject rows ("
+             << AttendanceBitmapIndex::kernelName() << " popcount)" << endl;
+    } else {
+        cerr << "Warning: attendance index not loaded; reports will be empty" << endl;
+    }
+    // Picks up marks written outside this server, e.g. through the CLI
+    int indexRefreshSeconds = config.count("attendance_index_refresh_s")
+                                  ? stoi(config.at("attendance_index_refresh_s")) : 300;
+    attendanceIndex->refreshEvery(chrono::seconds(max(indexRefreshSeconds, 0)));
+
+    // Session signing key. Without session_secret a random one is drawn, so
+    // restarting the server logs everyone out.
+    string sessionSecret = config.count("session_secret") ? config.at("session_secret") : "";
+    if (sessionSecret.empty()) {
+        cerr << "Warning: no session_secret configured; sessions end when the server restarts" << endl;
+        random_device entropy;
+        for (int i = 0; i < 32; ++i) {
+            sessionSecret += static_cast<char>(entropy() & 0xff);
+        }
+    }
+    int sessionMinutes = config.count("session_ttl_minutes") ? stoi(config.at("session_ttl_minutes")) : 480;
+    sessionTokens = new SessionTokens(sessionSecret, chrono::minutes(sessionMinutes));
 
     // Create HTTP server
     httplib::Server svr;
@@ -690,21 +1562,85 @@ int main() {
     svr.set_default_headers({
         {"Access-Control-Allow-Origin", "*"},
         {"Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS"},
-        {"Access-Control-Allow-Headers", "Content-Type"}
+        {"Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match"},
+        {"Access-Control-Expose-Headers", "Server-Timing, X-DB-Queries, ETag"},
+        {"Timing-Allow-Origin", "*"}
     });
 
-    // Logger
-    svr.set_logger([](const httplib::Request& req, const httplib::Response& res) {
-        cout << "[" << req.method << "] " << req.path << " -> " << res.status << endl;
+    // Access log: httplib's set_logger runs under a server-wide mutex, so
+    // requests are recorded from the post-routing hook instead, just before
+    // the response is written
+    string accessLogPath = config.count("access_log") ? config.at("access_log") : "access.log";
+    size_t accessLogMaxMb = config.count("access_log_max_mb") ? stoul(config.at("access_log_max_mb")) : 64;
+    int accessLogFiles = config.count("access_log_files") ? stoi(config.at("access_log_files")) : 5;
+    double accessLogSample = config.count("access_log_sample") ? stod(config.at("access_log_sample")) : 1.0;
+    accessLog = new AccessLog(accessLogPath, accessLogMaxMb << 20, accessLogFiles, accessLogSample);
+    if (accessLog->isOpen()) {
+        cout << "Access log: " << accessLogPath << " (sampling " << accessLogSample * 100 << "%)" << endl;
+    }
+
+    // Metrics; everything is registered here, before the first request
+    metrics = new MetricsRegistry();
+    requestLatency = &metrics->histograms("http_request_duration_seconds",
+                                          "Request latency by route", "method", "route");
+    dbCallLatency = &metrics->histograms("db_call_duration_seconds",
+                                         "Database call latency by method, excluding the pool wait", "method");
+    poolWait = &metrics->histogram("db_pool_wait_seconds", "Time spent waiting for a pooled connection");
+    poolTimeouts = &metrics->counter("db_pool_timeouts_total", "Connection leases that timed out");
+    metrics->gauge("db_pool_connections", "Open pooled connections", [] { return double(pool->size()); });
+    metrics->gauge("db_pool_idle_connections", "Pooled connections not leased", [] { return double(pool->idleCount()); });
+    metrics->counterFunction("db_reconnects_total", "Dropped MySQL connections re-established",
+                             [] { return double(MySqlDatabase::reconnects()); });
+    metrics->gauge("http_queued_requests", "Accepted requests waiting for a worker thread",
+                   [] { return double(queuedRequests.load(memory_order_relaxed)); });
+    metrics->gauge("attendance_write_queue_depth", "Attendance marks waiting for a group commit",
+                   [] { return double(writeQueue->depth()); });
+
+    tableVersions = new TableVersions();
+    coalescer = new RequestCoalescer();
+    coalescedRequests = &metrics->counter("http_coalesced_requests_total",
+                                          "Requests answered by an identical request already in flight");
+    metrics->gauge("http_coalesced_flights", "Coalescable requests currently running",
+                   [] { return double(coalescer->inFlight()); });
+
+    // Marks where routing ends and the handler starts, for Server-Timing
+    svr.set_pre_request_handler([](const httplib::Request&, httplib::Response&) {
+        requestTiming.handlerStart = chrono::steady_clock::now();
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
+
+    compressMinBytes = config.count("compress_min_bytes") ? stoul(config.at("compress_min_bytes")) : 1024;
+
+    svr.set_post_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+        compressResponse(req, res);
+        auto latency = chrono::steady_clock::now() - req.start_time_;
+        // Route patterns, not paths, keep the label set small
+        static const string unmatched = "(unmatched)", staticFile = "(static)";
+        const string& route = !req.matched_route.empty() ? req.matched_route
+                            : res.status == 404 ? unmatched : staticFile;
+        requestLatency->get(req.method, route).observe(latency);
+        res.set_header("Server-Timing", serverTimingHeader(latency));
+        res.set_header("X-DB-Queries", to_string(requestTiming.dbCalls));
+
+        size_t bytes = res.body.empty() ? res.content_length_ : res.body.size();
+        accessLog->log(req.method, req.path, res.status,
+                       chrono::duration_cast<chrono::microseconds>(latency),
+                       chrono::duration_cast<chrono::microseconds>(requestTiming.lease + requestTiming.db), bytes);
+        requestTiming = RequestTiming();  // this thread's next request starts clean
     });
 
     svr.Options(".*", [](const httplib::Request&, httplib::Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
         res.status = 200;
     });
 
+    // Prometheus scrape target; unauthenticated, like the static files
+    svr.Get("/metrics", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content(metrics->render(), "text/plain; version=0.0.4");
+    });
+
     // Setup endpoints
     setupAuthEndpoints(svr);
     setupSubjectEndpoints(svr);
@@ -714,17 +1650,18 @@ int main() {
     setupAttendanceEndpoints(svr);
 
     // Add error handler
-    svr.set_exception_handler([](const httplib::Request& req, httplib::Response& res, exception_ptr ep) {
+    svr.set_exception_handler([](const httplib::Request&, httplib::Response& res, exception_ptr ep) {
+        res.headers.erase("ETag");  // the tag set before the failure doesn't describe this reply
         try {
             rethrow_exception(ep);
         } catch (const exception& e) {
             cerr << "Exception in handler: " << e.what() << endl;
             res.status = 500;
-            res.set_content(errorResponse(string("Server error: ") + e.what()).dump(), "application/json");
+            sendJson(res, errorResponse(string("Server error: ") + e.what()));
         } catch (...) {
             cerr << "Unknown exception in handler" << endl;
             res.status = 500;
-            res.set_content(errorResponse("Unknown server error").dump(), "application/json");
+            sendJson(res, errorResponse("Unknown server error"));
         }
     });
 
@@ -752,11 +1689,22 @@ int main() {
         cerr << "Start the server from the project root or adjust paths." << endl;
         return 1;
     }
+    // Files are served from memory; the mount point only covers files
+    // too large to load
+    staticAssets = new StaticAssets();
+    size_t assetCount = staticAssets->load(staticDir);
+    cout << "Static files: " << assetCount << " loaded, " << staticAssets->totalBytes() / 1024 << " KB ("
+         << staticAssets->totalGzippedBytes() / 1024 << " KB gzipped)" << endl;
+    svr.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+        return serveStaticAsset(req, res) ? httplib::Server::HandlerResponse::Handled
+                                          : httplib::Server::HandlerResponse::Unhandled;
+    });
     svr.set_mount_point("/", staticDir.c_str());
     
-    // Set multi-threaded mode (8 threads)
-    // Note: Database access is protected by mutex, so this is safe but serialized at DB level
-    svr.new_task_queue = [] { return new httplib::ThreadPool(8); };
+    // Set multi-threaded mode; workers lease pooled connections per query,
+    // so database work now runs in parallel up to pool_max_size
+    size_t workerThreads = config.count("server_threads") ? stoul(config.at("server_threads")) : 8;
+    svr.new_task_queue = [workerThreads] { return new CountingTaskQueue(workerThreads); };
 
     cout << "API Server running on http://localhost:8080" << endl;
     cout << "Access web interface at http://localhost:8080" << endl;
@@ -764,7 +1712,17 @@ int main() {
     // Start server
     svr.listen("0.0.0.0", 8080);
 
-    // Cleanup
-    delete db;
+    // Cleanup; the write queue commits anything still queued first
+    delete writeQueue;
+    delete accessLog;
+    delete coalescer;
+    delete staticAssets;
+    delete tableVersions;
+    delete metrics;
+    delete attendanceIndex;
+    delete sessionTokens;
+    delete teacherAssignments;
+    delete referenceCache;
+    delete pool;
     return 0;
 }